@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""Benchmark the whisper extension: decode, model load, inference and result materialization.
+
+Each case runs in a fresh DuckDB CLI process so model loads are cold and peak RSS is per case.
+Inputs are generated from test/data/test_english.wav with the ffmpeg CLI (looped to the requested
+length and re-encoded per codec), so no extra test data has to be checked in.
+
+Usage:
+    python3 scripts/benchmark.py [--duckdb build/release/duckdb] [--models tiny.en,base.en]
+                                 [--lengths 10,60,300] [--codecs wav,mp3,flac,opus]
+                                 [--threads 1,4] [--output results.csv]
+
+Reported per case (seconds unless noted):
+    load_s          whisper_preload_model (cold model load)
+    decode_s        whisper_decode_audio (FFmpeg or native WAV decode + resample)
+    transcribe_s    whisper_transcribe with a warm model (decode + inference)
+    inference_s     transcribe_s - decode_s
+    segments_s      whisper_transcribe_segments materialized into a temp table, served from the result cache
+                    filled by the transcribe step, so it excludes decode and inference
+    rtf             inference_s / audio length (lower is better, < 1 is faster than real time)
+    peak_rss_mb     peak resident memory of the DuckDB process
+"""
+
+import argparse
+import csv
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SOURCE_AUDIO = os.path.join(ROOT, "test", "data", "test_english.wav")
+
+# ffmpeg output arguments per codec (all derived from the 16kHz mono source)
+CODECS = {
+    "wav": ("wav", ["-c:a", "pcm_s16le", "-ar", "16000", "-ac", "1"]),  # native fast path
+    "wav44": ("wav", ["-c:a", "pcm_s16le", "-ar", "44100", "-ac", "2"]),  # needs resampling
+    "mp3": ("mp3", ["-c:a", "libmp3lame", "-b:a", "128k"]),
+    "flac": ("flac", ["-c:a", "flac"]),
+    "opus": ("ogg", ["-c:a", "libopus", "-b:a", "48k"]),
+}
+
+TIMER_PATTERN = re.compile(r"Run Time \(s\): real ([0-9.]+)")
+
+
+def generate_input(workdir, codec, seconds):
+    extension, codec_args = CODECS[codec]
+    path = os.path.join(workdir, f"bench_{seconds}s_{codec}.{extension}")
+    if not os.path.exists(path):
+        command = ["ffmpeg", "-loglevel", "error", "-y", "-stream_loop", "-1", "-i", SOURCE_AUDIO,
+                   "-t", str(seconds)] + codec_args + [path]
+        if subprocess.run(command).returncode != 0:
+            return None
+    return path
+
+
+def run_case(duckdb, model, audio_path, threads):
+    quoted = audio_path.replace("'", "''")
+    script = "\n".join([
+        f"SET whisper_threads = {threads};",
+        # The transcribe step fills the in-memory cache; the segments step then only materializes rows
+        "SET whisper_cache = true;",
+        "SET whisper_cache_persist = false;",
+        ".timer on",
+        f"SELECT whisper_preload_model('{model}');",
+        f"SELECT whisper_decode_audio('{quoted}');",
+        f"SELECT length(whisper_transcribe('{quoted}', '{model}'));",
+        f"CREATE TEMP TABLE segments AS SELECT * FROM whisper_transcribe_segments('{quoted}', '{model}');",
+        ".timer off",
+        "SELECT 'samples=' || whisper_decode_audio('" + quoted + "');",
+        "SELECT 'cache_hits=' || hits FROM whisper_cache_stats();",
+    ]) + "\n"
+
+    # communicate() would reap the child itself, and wait4 is needed for the rusage of this child alone (unlike
+    # getrusage(RUSAGE_CHILDREN)). The script and stderr go through temporary files instead, so stdout is the only
+    # pipe and the child can never block on a full stderr pipe while stdout is being read.
+    with tempfile.TemporaryFile("w+") as stdin_file, tempfile.TemporaryFile("w+") as stderr_file:
+        stdin_file.write(script)
+        stdin_file.seek(0)
+        process = subprocess.Popen([duckdb, "-unsigned", "-batch"], stdin=stdin_file, stdout=subprocess.PIPE,
+                                   stderr=stderr_file, text=True)
+        stdout = process.stdout.read()
+        _, status, usage = os.wait4(process.pid, 0)
+        process.returncode = os.waitstatus_to_exitcode(status)
+        stderr_file.seek(0)
+        stderr = stderr_file.read()
+    if process.returncode != 0 or "Error" in stderr:
+        raise RuntimeError(stderr.strip() or f"duckdb exited with {process.returncode}")
+
+    timings = [float(value) for value in TIMER_PATTERN.findall(stdout)]
+    if len(timings) < 4:
+        raise RuntimeError("could not parse timings from duckdb output:\n" + stdout)
+    samples = int(re.search(r"samples=(\d+)", stdout).group(1))
+    if int(re.search(r"cache_hits=(\d+)", stdout).group(1)) == 0:
+        raise RuntimeError("segments step missed the result cache, so segments_s would include inference")
+
+    # ru_maxrss is in kilobytes on Linux and bytes on macOS
+    rss_divisor = 1024 * 1024 if sys.platform == "darwin" else 1024
+    load, decode, transcribe, segments = timings[:4]
+    audio_seconds = samples / 16000.0
+    inference = max(transcribe - decode, 0.0)
+    return {
+        "load_s": load,
+        "decode_s": decode,
+        "transcribe_s": transcribe,
+        "inference_s": inference,
+        "segments_s": segments,
+        "audio_s": audio_seconds,
+        "rtf": inference / audio_seconds if audio_seconds > 0 else 0.0,
+        "peak_rss_mb": usage.ru_maxrss / rss_divisor,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--duckdb", default=os.path.join(ROOT, "build", "release", "duckdb"))
+    parser.add_argument("--models", default="tiny.en")
+    parser.add_argument("--lengths", default="10,60,300", help="audio lengths in seconds")
+    parser.add_argument("--codecs", default="wav,wav44,mp3,flac,opus")
+    parser.add_argument("--threads", default="1,4")
+    parser.add_argument("--output", help="write results as CSV to this file (default: stdout)")
+    args = parser.parse_args()
+
+    if shutil.which("ffmpeg") is None:
+        sys.exit("ffmpeg CLI is required to generate benchmark inputs")
+    if not os.path.exists(args.duckdb):
+        sys.exit(f"DuckDB binary not found at {args.duckdb} (build with `make release` or pass --duckdb)")
+
+    fields = ["model", "codec", "length_s", "threads", "audio_s", "load_s", "decode_s", "transcribe_s",
+              "inference_s", "segments_s", "rtf", "peak_rss_mb"]
+    output = open(args.output, "w", newline="") if args.output else sys.stdout
+    writer = csv.DictWriter(output, fieldnames=fields)
+    writer.writeheader()
+
+    with tempfile.TemporaryDirectory(prefix="whisper_bench_") as workdir:
+        for codec in args.codecs.split(","):
+            for seconds in [int(value) for value in args.lengths.split(",")]:
+                audio_path = generate_input(workdir, codec, seconds)
+                if audio_path is None:
+                    print(f"skipping {codec}: ffmpeg could not encode it", file=sys.stderr)
+                    break
+                for model in args.models.split(","):
+                    for threads in [int(value) for value in args.threads.split(",")]:
+                        try:
+                            row = run_case(args.duckdb, model, audio_path, threads)
+                        except RuntimeError as ex:
+                            print(f"{model}/{codec}/{seconds}s/{threads}t failed: {ex}", file=sys.stderr)
+                            continue
+                        row.update({"model": model, "codec": codec, "length_s": seconds, "threads": threads})
+                        writer.writerow({key: round(value, 4) if isinstance(value, float) else value
+                                         for key, value in row.items()})
+                        output.flush()
+
+    if output is not sys.stdout:
+        output.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,237 @@
+#include "audio_header.hpp"
+#include "mapped_file.hpp"
+
+#include <cstring>
+
+namespace duckdb {
+
+// How far past the ID3 tag to look for the first MP3 frame
+static constexpr size_t MP3_SYNC_SEARCH_BYTES = 64 * 1024;
+static constexpr size_t ID3V1_TAG_BYTES = 128;
+
+// WAVE format tags whose duration follows from the byte rate (compressed tags go to FFmpeg)
+static constexpr uint16_t WAVE_FORMAT_PCM = 0x0001;
+static constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+static constexpr uint16_t WAVE_FORMAT_ALAW = 0x0006;
+static constexpr uint16_t WAVE_FORMAT_MULAW = 0x0007;
+static constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+static constexpr size_t WAVE_EXTENSIBLE_FMT_BYTES = 40;
+
+static uint16_t ReadLE16(const uint8_t *p) {
+	return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t ReadLE32(const uint8_t *p) {
+	return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+	       (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static uint32_t ReadBE32(const uint8_t *p) {
+	return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+	       (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+static bool IsUncompressedWaveFormat(uint16_t format_tag) {
+	return format_tag == WAVE_FORMAT_PCM || format_tag == WAVE_FORMAT_IEEE_FLOAT || format_tag == WAVE_FORMAT_ALAW ||
+	       format_tag == WAVE_FORMAT_MULAW;
+}
+
+bool AudioHeaderReader::ReadWav(const uint8_t *data, size_t size, AudioMetadata &metadata) {
+	if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+		return false;
+	}
+
+	uint16_t channels = 0;
+	uint32_t sample_rate = 0;
+	uint32_t byte_rate = 0;
+	bool have_fmt = false;
+
+	// Walk the chunk list up to the data chunk (chunks are padded to even sizes)
+	size_t pos = 12;
+	while (pos + 8 <= size) {
+		const uint8_t *chunk = data + pos;
+		size_t chunk_size = ReadLE32(chunk + 4);
+		size_t body = pos + 8;
+
+		if (memcmp(chunk, "fmt ", 4) == 0) {
+			if (chunk_size < 16 || body + chunk_size > size) {
+				return false;
+			}
+			// WAVE_FORMAT_EXTENSIBLE carries the real tag in the first two bytes of its SubFormat GUID
+			uint16_t format_tag = ReadLE16(data + body);
+			if (format_tag == WAVE_FORMAT_EXTENSIBLE) {
+				if (chunk_size < WAVE_EXTENSIBLE_FMT_BYTES) {
+					return false;
+				}
+				format_tag = ReadLE16(data + body + 24);
+			}
+			if (!IsUncompressedWaveFormat(format_tag)) {
+				return false;
+			}
+			channels = ReadLE16(data + body + 2);
+			sample_rate = ReadLE32(data + body + 4);
+			byte_rate = ReadLE32(data + body + 8);
+			have_fmt = true;
+		} else if (memcmp(chunk, "data", 4) == 0) {
+			if (!have_fmt || channels == 0 || sample_rate == 0 || byte_rate == 0) {
+				return false;
+			}
+
+			// Streaming writers may leave the size unset; clamp to what is actually present
+			size_t data_size = chunk_size < size - body ? chunk_size : size - body;
+			metadata.duration_seconds = static_cast<double>(data_size) / static_cast<double>(byte_rate);
+			metadata.sample_rate = static_cast<int>(sample_rate);
+			metadata.channels = channels;
+			metadata.format = "wav";
+			return true;
+		}
+
+		pos = body + chunk_size + (chunk_size & 1);
+	}
+	return false;
+}
+
+bool AudioHeaderReader::ReadFlac(const uint8_t *data, size_t size, AudioMetadata &metadata) {
+	// "fLaC", then the mandatory STREAMINFO block (type 0, 34 bytes)
+	if (size < 42 || memcmp(data, "fLaC", 4) != 0 || (data[4] & 0x7F) != 0) {
+		return false;
+	}
+
+	// STREAMINFO packs sample rate (20 bits), channels - 1 (3), bits per sample - 1 (5), total samples (36)
+	const uint8_t *info = data + 18;
+	uint32_t sample_rate = (static_cast<uint32_t>(info[0]) << 12) | (static_cast<uint32_t>(info[1]) << 4) |
+	                       (static_cast<uint32_t>(info[2]) >> 4);
+	int channels = ((info[2] >> 1) & 0x07) + 1;
+	uint64_t total_samples = (static_cast<uint64_t>(info[3] & 0x0F) << 32) | ReadBE32(info + 4);
+
+	// An unknown sample count (0) can only be found by scanning the frames
+	if (sample_rate == 0 || total_samples == 0) {
+		return false;
+	}
+
+	metadata.duration_seconds = static_cast<double>(total_samples) / static_cast<double>(sample_rate);
+	metadata.sample_rate = static_cast<int>(sample_rate);
+	metadata.channels = channels;
+	metadata.format = "flac";
+	return true;
+}
+
+// A parsed MPEG audio Layer III frame header
+struct Mp3FrameHeader {
+	bool mpeg1;
+	int sample_rate;
+	int bitrate_kbps;
+	int channels;
+	size_t frame_size;
+	int samples_per_frame;
+};
+
+static bool ParseMp3FrameHeader(const uint8_t *p, Mp3FrameHeader &header) {
+	static const int MPEG1_BITRATES[] = {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320};
+	static const int MPEG2_BITRATES[] = {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160};
+	static const int MPEG1_SAMPLE_RATES[] = {44100, 48000, 32000};
+
+	if (p[0] != 0xFF || (p[1] & 0xE0) != 0xE0) {
+		return false;
+	}
+	int version = (p[1] >> 3) & 0x03; // 0 = MPEG 2.5, 1 = reserved, 2 = MPEG 2, 3 = MPEG 1
+	int layer = (p[1] >> 1) & 0x03;   // 1 = Layer III
+	int bitrate_idx = p[2] >> 4;
+	int sample_rate_idx = (p[2] >> 2) & 0x03;
+	if (version == 1 || layer != 1 || bitrate_idx == 0 || bitrate_idx == 15 || sample_rate_idx == 3) {
+		return false;
+	}
+
+	header.mpeg1 = version == 3;
+	header.sample_rate = MPEG1_SAMPLE_RATES[sample_rate_idx] >> (version == 3 ? 0 : version == 2 ? 1 : 2);
+	header.bitrate_kbps = header.mpeg1 ? MPEG1_BITRATES[bitrate_idx] : MPEG2_BITRATES[bitrate_idx];
+	header.channels = (p[3] >> 6) == 3 ? 1 : 2;
+	header.samples_per_frame = header.mpeg1 ? 1152 : 576;
+	size_t padding = (p[2] >> 1) & 0x01;
+	size_t bytes_per_second = static_cast<size_t>(header.bitrate_kbps) * 1000 / 8;
+	header.frame_size = bytes_per_second * header.samples_per_frame / header.sample_rate + padding;
+	return true;
+}
+
+bool AudioHeaderReader::ReadMp3(const uint8_t *data, size_t size, AudioMetadata &metadata) {
+	// Skip an ID3v2 tag (syncsafe size, plus a footer when flagged)
+	size_t pos = 0;
+	if (size >= 10 && memcmp(data, "ID3", 3) == 0) {
+		size_t tag_size = (static_cast<size_t>(data[6] & 0x7F) << 21) | (static_cast<size_t>(data[7] & 0x7F) << 14) |
+		                  (static_cast<size_t>(data[8] & 0x7F) << 7) | static_cast<size_t>(data[9] & 0x7F);
+		pos = 10 + tag_size + ((data[5] & 0x10) ? 10 : 0);
+	}
+
+	// Find the first frame; a candidate only counts when the next frame header follows it
+	Mp3FrameHeader header;
+	size_t search_end = pos + MP3_SYNC_SEARCH_BYTES < size ? pos + MP3_SYNC_SEARCH_BYTES : size;
+	bool found = false;
+	for (; pos + 4 <= search_end; pos++) {
+		Mp3FrameHeader next;
+		if (ParseMp3FrameHeader(data + pos, header) && pos + header.frame_size + 4 <= size &&
+		    ParseMp3FrameHeader(data + pos + header.frame_size, next)) {
+			found = true;
+			break;
+		}
+	}
+	if (!found) {
+		return false;
+	}
+
+	// VBR files carry the frame count in a Xing/Info tag (after the side info) or a VBRI tag (at offset 36)
+	uint32_t n_frames = 0;
+	size_t side_info = header.mpeg1 ? (header.channels == 1 ? 17 : 32) : (header.channels == 1 ? 9 : 17);
+	size_t xing = pos + 4 + side_info;
+	size_t vbri = pos + 36;
+	if (xing + 12 <= size && (memcmp(data + xing, "Xing", 4) == 0 || memcmp(data + xing, "Info", 4) == 0)) {
+		if (ReadBE32(data + xing + 4) & 0x01) {
+			n_frames = ReadBE32(data + xing + 8);
+		}
+	} else if (vbri + 18 <= size && memcmp(data + vbri, "VBRI", 4) == 0) {
+		n_frames = ReadBE32(data + vbri + 14);
+	}
+
+	if (n_frames > 0) {
+		metadata.duration_seconds = static_cast<double>(n_frames) * header.samples_per_frame / header.sample_rate;
+	} else {
+		// Constant bitrate: the duration follows from the audio size
+		size_t audio_end = size;
+		if (size - pos >= ID3V1_TAG_BYTES && memcmp(data + size - ID3V1_TAG_BYTES, "TAG", 3) == 0) {
+			audio_end -= ID3V1_TAG_BYTES;
+		}
+		metadata.duration_seconds =
+		    static_cast<double>(audio_end - pos) * 8.0 / (static_cast<double>(header.bitrate_kbps) * 1000.0);
+	}
+	metadata.sample_rate = header.sample_rate;
+	metadata.channels = header.channels;
+	metadata.format = "mp3";
+	return true;
+}
+
+bool AudioHeaderReader::ReadMemory(const uint8_t *data, size_t size, AudioMetadata &metadata) {
+	if (!data || size < 4) {
+		return false;
+	}
+	metadata.file_size = static_cast<int64_t>(size);
+	if (memcmp(data, "RIFF", 4) == 0) {
+		return ReadWav(data, size, metadata);
+	}
+	if (memcmp(data, "fLaC", 4) == 0) {
+		return ReadFlac(data, size, metadata);
+	}
+	if (memcmp(data, "ID3", 3) == 0 || (data[0] == 0xFF && (data[1] & 0xE0) == 0xE0)) {
+		return ReadMp3(data, size, metadata);
+	}
+	return false;
+}
+
+bool AudioHeaderReader::ReadFile(const std::string &file_path, AudioMetadata &metadata) {
+	// Only the pages holding the headers (and an MP3's ID3v1 tag) are read
+	MappedFile file(file_path);
+	if (!file.Data()) {
+		return false;
+	}
+	return ReadMemory(file.Data(), file.Size(), metadata);
+}
+
+} // namespace duckdb
@@ -14,15 +14,20 @@ bool AudioRecorder::sdl_initialized_ = false;
 static std::mutex sdl_mutex_;
 
 AudioRecorder::AudioRecorder()
-    : device_id_(0), recording_(false), sample_rate_(16000), current_amplitude_(0.0f), silence_threshold_(0.01f),
-      silence_duration_sec_(0.0), silence_start_time_(0.0), silence_detected_(false) {
+    : device_id_(0), ring_(RING_CAPACITY), taken_samples_(0), dropped_samples_(0), recording_(false),
+      sample_rate_(16000), current_amplitude_(0.0f), silence_threshold_(0.01f), silence_duration_sec_(0.0),
+      silence_start_time_(-1.0), had_sound_(false), silence_detected_(false) {
 }
 
 AudioRecorder::~AudioRecorder() {
+	recording_ = false;
 	if (device_id_ != 0) {
 		SDL_CloseAudioDevice(device_id_);
 		device_id_ = 0;
 	}
+	if (drain_thread_.joinable()) {
+		drain_thread_.join();
+	}
 }
 
 std::vector<AudioDevice> AudioRecorder::ListDevices() {
@@ -59,16 +64,24 @@ void AudioRecorder::AudioCallback(void *userdata, unsigned char *stream, int len
 		return;
 	}
 
-	// Convert from int16 to float and append to buffer
+	// Convert from int16 to float into the ring buffer; this runs on SDL's audio thread, so no allocation or locks
 	int16_t *samples = reinterpret_cast<int16_t *>(stream);
 	int num_samples = len / sizeof(int16_t);
 
 	// Calculate RMS amplitude for this chunk
 	float sum_squares = 0.0f;
-	for (int i = 0; i < num_samples; i++) {
-		float sample = static_cast<float>(samples[i]) / 32768.0f;
-		recorder->buffer_.push_back(sample);
-		sum_squares += sample * sample;
+	float converted[1024];
+	for (int offset = 0; offset < num_samples; offset += 1024) {
+		int n = num_samples - offset < 1024 ? num_samples - offset : 1024;
+		for (int i = 0; i < n; i++) {
+			float sample = static_cast<float>(samples[offset + i]) / 32768.0f;
+			converted[i] = sample;
+			sum_squares += sample * sample;
+		}
+		size_t written = recorder->ring_.Write(converted, static_cast<size_t>(n));
+		if (written < static_cast<size_t>(n)) {
+			recorder->dropped_samples_ += static_cast<size_t>(n) - written;
+		}
 	}
 
 	if (num_samples > 0) {
@@ -119,29 +132,66 @@ bool AudioRecorder::StartRecording(int device_id, std::string &error) {
 
 	device_id_ = dev;
 	sample_rate_ = obtained.freq;
+	ring_.Clear();
 	buffer_.clear();
+	taken_samples_ = 0;
+	dropped_samples_ = 0;
+	had_sound_ = false;
+	silence_start_time_ = -1.0;
+	silence_detected_ = false;
 	recording_ = true;
 
-	// Start capture
+	// Start capture; the drain thread keeps the ring buffer empty however long the consumer is busy
+	drain_thread_ = std::thread(&AudioRecorder::DrainLoop, this);
 	SDL_PauseAudioDevice(dev, 0);
 
 	return true;
 }
 
-bool AudioRecorder::StopRecording(std::vector<float> &pcm_data, std::string &error) {
-	if (!recording_) {
-		error = "Not recording";
-		return false;
-	}
-
+void AudioRecorder::Stop() {
 	recording_ = false;
 
+	// Closing the device waits for a running callback, so the ring buffer has no producer afterwards
 	if (device_id_ != 0) {
 		SDL_PauseAudioDevice(device_id_, 1);
 		SDL_CloseAudioDevice(device_id_);
 		device_id_ = 0;
 	}
+	// With the drain thread gone as well, this thread becomes the ring buffer's only consumer
+	if (drain_thread_.joinable()) {
+		drain_thread_.join();
+	}
+	Drain();
+}
+
+void AudioRecorder::Drain() {
+	std::lock_guard<std::mutex> lock(buffer_mutex_);
+	ring_.Read(buffer_);
+}
+
+void AudioRecorder::DrainLoop() {
+	while (recording_) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(DRAIN_INTERVAL_MS));
+		Drain();
+	}
+}
+
+void AudioRecorder::TakeCaptured(std::vector<float> &pcm_data) {
+	std::lock_guard<std::mutex> lock(buffer_mutex_);
+	pcm_data.insert(pcm_data.end(), buffer_.begin(), buffer_.end());
+	taken_samples_ += buffer_.size();
+	buffer_.clear();
+}
+
+bool AudioRecorder::StopRecording(std::vector<float> &pcm_data, std::string &error) {
+	if (!recording_) {
+		error = "Not recording";
+		return false;
+	}
+
+	Stop();
 
+	std::lock_guard<std::mutex> lock(buffer_mutex_);
 	if (buffer_.empty()) {
 		error = "No audio data recorded";
 		return false;
@@ -149,6 +199,7 @@ bool AudioRecorder::StopRecording(std::vector<float> &pcm_data, std::string &err
 
 	// If sample rate differs from 16kHz, we'd need to resample
 	// For now, we request 16kHz directly from SDL
+	taken_samples_ += buffer_.size();
 	pcm_data = std::move(buffer_);
 	buffer_.clear();
 
@@ -162,54 +213,67 @@ bool AudioRecorder::IsRecording() const {
 double AudioRecorder::GetRecordingDuration() const {
 	if (sample_rate_ <= 0)
 		return 0.0;
-	return static_cast<double>(buffer_.size()) / sample_rate_;
+	std::lock_guard<std::mutex> lock(buffer_mutex_);
+	return static_cast<double>(taken_samples_ + buffer_.size() + ring_.Size()) / sample_rate_;
 }
 
-bool AudioRecorder::RecordUntilSilence(std::vector<float> &pcm_data, double max_duration_sec,
-                                       double silence_duration_sec, float silence_threshold, int device_id,
-                                       std::string &error) {
-	// Start recording
-	if (!StartRecording(device_id, error)) {
-		return false;
-	}
+size_t AudioRecorder::DroppedSamples() const {
+	return dropped_samples_.load();
+}
 
+void AudioRecorder::SetSilenceStop(float silence_threshold, double silence_duration_sec) {
 	silence_threshold_ = silence_threshold;
 	silence_duration_sec_ = silence_duration_sec;
-	silence_detected_ = false;
+}
 
-	auto start_time = std::chrono::steady_clock::now();
-	double silence_start = -1.0;
-	bool had_sound = false; // Track if we ever detected sound
+bool AudioRecorder::SilenceElapsed() {
+	float amplitude = current_amplitude_.load();
+	double now = GetRecordingDuration();
+
+	if (amplitude > silence_threshold_) {
+		// Sound detected
+		had_sound_ = true;
+		silence_start_time_ = -1.0; // Reset silence timer
+	} else if (had_sound_) {
+		// Silence after sound was detected
+		if (silence_start_time_ < 0) {
+			silence_start_time_ = now;
+		} else if (now - silence_start_time_ >= silence_duration_sec_) {
+			return true;
+		}
+	}
+	return false;
+}
 
-	while (recording_) {
-		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+bool AudioRecorder::Capture(double seconds) {
+	auto start_time = std::chrono::steady_clock::now();
 
-		auto now = std::chrono::steady_clock::now();
-		double elapsed = std::chrono::duration<double>(now - start_time).count();
+	while (recording_ && !silence_detected_) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(DRAIN_INTERVAL_MS));
 
-		// Check max duration
-		if (elapsed >= max_duration_sec) {
+		if (silence_duration_sec_ > 0.0 && SilenceElapsed()) {
+			silence_detected_ = true;
 			break;
 		}
 
-		// Check amplitude for silence detection
-		float amplitude = current_amplitude_.load();
-
-		if (amplitude > silence_threshold) {
-			// Sound detected
-			had_sound = true;
-			silence_start = -1.0; // Reset silence timer
-		} else if (had_sound) {
-			// Silence after sound was detected
-			if (silence_start < 0) {
-				silence_start = elapsed;
-			} else if (elapsed - silence_start >= silence_duration_sec) {
-				// Silence duration exceeded
-				silence_detected_ = true;
-				break;
-			}
+		auto now = std::chrono::steady_clock::now();
+		if (std::chrono::duration<double>(now - start_time).count() >= seconds) {
+			break;
 		}
 	}
+	return silence_detected_;
+}
+
+bool AudioRecorder::RecordUntilSilence(std::vector<float> &pcm_data, double max_duration_sec,
+                                       double silence_duration_sec, float silence_threshold, int device_id,
+                                       std::string &error) {
+	// Start recording
+	if (!StartRecording(device_id, error)) {
+		return false;
+	}
+
+	SetSilenceStop(silence_threshold, silence_duration_sec);
+	Capture(max_duration_sec);
 
 	return StopRecording(pcm_data, error);
 }
@@ -1,4 +1,6 @@
 #include "audio_utils.hpp"
+#include "audio_header.hpp"
+#include "wav_reader.hpp"
 
 extern "C" {
 #include <libavcodec/avcodec.h>
@@ -11,7 +13,9 @@ extern "C" {
 }
 
 #include <fstream>
+#include <algorithm>
 #include <cstring>
+#include <utility>
 
 // Check for new channel layout API (FFmpeg 5.1+, libavutil >= 57.28.100)
 // The new API uses AVChannelLayout struct and swr_alloc_set_opts2
@@ -21,30 +25,49 @@ extern "C" {
 #define FFMPEG_NEW_CHANNEL_API 0
 #endif
 
+// av_find_input_format returns a const pointer since FFmpeg 5.0 (libavformat 59)
+#if LIBAVFORMAT_VERSION_MAJOR >= 59
+typedef const AVInputFormat FFmpegInputFormat;
+#else
+typedef AVInputFormat FFmpegInputFormat;
+#endif
+
 namespace duckdb {
 
-bool AudioUtils::LoadAudioFile(const std::string &file_path, std::vector<float> &output, std::string &error) {
+// whisper expects 16kHz mono float32 PCM
+static constexpr int WHISPER_SAMPLE_RATE = 16000;
+
+// AVIO buffer for in-memory input: grows with the input so large BLOBs are not fed to the demuxer in tiny reads
+static size_t GetAvioBufferSize(size_t input_size) {
+	const size_t min_size = 4096;
+	const size_t max_size = 1 << 20;
+	size_t buffer_size = min_size;
+	while (buffer_size < max_size && buffer_size * 64 < input_size) {
+		buffer_size *= 2;
+	}
+	return buffer_size;
+}
+
+bool AudioUtils::GetAudioMetadata(const std::string &file_path, AudioMetadata &metadata, std::string &error) {
+	// WAV, FLAC and MP3 headers hold everything needed; stream probing can decode frames
+	if (AudioHeaderReader::ReadFile(file_path, metadata)) {
+		return true;
+	}
+
 	AVFormatContext *format_ctx = nullptr;
-	AVCodecContext *codec_ctx = nullptr;
-	SwrContext *swr_ctx = nullptr;
-	AVPacket *packet = nullptr;
-	AVFrame *frame = nullptr;
-	int audio_stream_idx = -1;
 
-	// Open input file
 	if (avformat_open_input(&format_ctx, file_path.c_str(), nullptr, nullptr) < 0) {
 		error = "Failed to open audio file: " + file_path;
 		return false;
 	}
 
-	// Find stream info
 	if (avformat_find_stream_info(format_ctx, nullptr) < 0) {
 		error = "Failed to find stream info";
 		avformat_close_input(&format_ctx);
 		return false;
 	}
 
-	// Find audio stream
+	int audio_stream_idx = -1;
 	for (unsigned int i = 0; i < format_ctx->nb_streams; i++) {
 		if (format_ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
 			audio_stream_idx = i;
@@ -58,196 +81,237 @@ bool AudioUtils::LoadAudioFile(const std::string &file_path, std::vector<float>
 		return false;
 	}
 
-	AVCodecParameters *codecpar = format_ctx->streams[audio_stream_idx]->codecpar;
+	AVStream *stream = format_ctx->streams[audio_stream_idx];
+	AVCodecParameters *codecpar = stream->codecpar;
 
-	// Find decoder
-	const AVCodec *codec = avcodec_find_decoder(codecpar->codec_id);
-	if (!codec) {
-		error = "Unsupported audio codec";
-		avformat_close_input(&format_ctx);
-		return false;
-	}
+	metadata.duration_seconds =
+	    format_ctx->duration > 0 ? static_cast<double>(format_ctx->duration) / AV_TIME_BASE : 0.0;
+	metadata.sample_rate = codecpar->sample_rate;
+#if FFMPEG_NEW_CHANNEL_API
+	metadata.channels = codecpar->ch_layout.nb_channels;
+#else
+	metadata.channels = codecpar->channels;
+#endif
+	metadata.format = format_ctx->iformat->name;
 
-	// Allocate codec context
-	codec_ctx = avcodec_alloc_context3(codec);
-	if (!codec_ctx) {
-		error = "Failed to allocate codec context";
-		avformat_close_input(&format_ctx);
-		return false;
-	}
+	// Get file size
+	std::ifstream file(file_path, std::ios::binary | std::ios::ate);
+	metadata.file_size = file.is_open() ? static_cast<int64_t>(file.tellg()) : 0;
 
-	if (avcodec_parameters_to_context(codec_ctx, codecpar) < 0) {
-		error = "Failed to copy codec parameters";
-		avcodec_free_context(&codec_ctx);
-		avformat_close_input(&format_ctx);
-		return false;
-	}
+	avformat_close_input(&format_ctx);
+	return true;
+}
 
-	if (avcodec_open2(codec_ctx, codec, nullptr) < 0) {
-		error = "Failed to open codec";
-		avcodec_free_context(&codec_ctx);
-		avformat_close_input(&format_ctx);
-		return false;
+bool AudioUtils::CheckAudioFile(const std::string &file_path, std::string &error) {
+	// A well-formed PCM/float WAV, FLAC or MP3 header is enough, FFmpeg decodes all of them; anything else is probed
+	AudioMetadata metadata;
+	if (AudioHeaderReader::ReadFile(file_path, metadata)) {
+		return true;
 	}
 
-	// Set up resampler for 16kHz mono float32
-#if FFMPEG_NEW_CHANNEL_API
-	AVChannelLayout out_ch_layout = AV_CHANNEL_LAYOUT_MONO;
-	AVChannelLayout in_ch_layout;
+	AVFormatContext *format_ctx = nullptr;
 
-	if (codec_ctx->ch_layout.nb_channels > 0) {
-		av_channel_layout_copy(&in_ch_layout, &codec_ctx->ch_layout);
-	} else {
-		av_channel_layout_default(&in_ch_layout,
-		                          codecpar->ch_layout.nb_channels > 0 ? codecpar->ch_layout.nb_channels : 2);
+	if (avformat_open_input(&format_ctx, file_path.c_str(), nullptr, nullptr) < 0) {
+		error = "Cannot open file or unsupported format";
+		return false;
 	}
 
-	swr_alloc_set_opts2(&swr_ctx, &out_ch_layout, AV_SAMPLE_FMT_FLT, WHISPER_SAMPLE_RATE, &in_ch_layout,
-	                    codec_ctx->sample_fmt, codec_ctx->sample_rate, 0, nullptr);
-
-	if (!swr_ctx || swr_init(swr_ctx) < 0) {
-		error = "Failed to initialize resampler";
-		av_channel_layout_uninit(&in_ch_layout);
-		avcodec_free_context(&codec_ctx);
+	if (avformat_find_stream_info(format_ctx, nullptr) < 0) {
+		error = "Cannot read stream info";
 		avformat_close_input(&format_ctx);
 		return false;
 	}
 
-	av_channel_layout_uninit(&in_ch_layout);
-#else
-	// Legacy FFmpeg API (< 5.1)
-	int64_t in_channel_layout = codec_ctx->channel_layout;
-	int in_channels = codec_ctx->channels;
-
-	if (in_channel_layout == 0) {
-		in_channel_layout = av_get_default_channel_layout(in_channels > 0 ? in_channels : 2);
-	}
-	if (in_channels == 0) {
-		in_channels = av_get_channel_layout_nb_channels(in_channel_layout);
-	}
-
-	swr_ctx = swr_alloc_set_opts(nullptr, AV_CH_LAYOUT_MONO, AV_SAMPLE_FMT_FLT, WHISPER_SAMPLE_RATE, in_channel_layout,
-	                             codec_ctx->sample_fmt, codec_ctx->sample_rate, 0, nullptr);
-
-	if (!swr_ctx || swr_init(swr_ctx) < 0) {
-		error = "Failed to initialize resampler";
-		avcodec_free_context(&codec_ctx);
-		avformat_close_input(&format_ctx);
-		return false;
+	bool has_audio = false;
+	for (unsigned int i = 0; i < format_ctx->nb_streams; i++) {
+		if (format_ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
+			AVCodecParameters *codecpar = format_ctx->streams[i]->codecpar;
+			const AVCodec *codec = avcodec_find_decoder(codecpar->codec_id);
+			if (codec) {
+				has_audio = true;
+				break;
+			}
+		}
 	}
-#endif
 
-	packet = av_packet_alloc();
-	frame = av_frame_alloc();
+	avformat_close_input(&format_ctx);
 
-	if (!packet || !frame) {
-		error = "Failed to allocate packet/frame";
-		if (packet)
-			av_packet_free(&packet);
-		if (frame)
-			av_frame_free(&frame);
-		swr_free(&swr_ctx);
-		avcodec_free_context(&codec_ctx);
-		avformat_close_input(&format_ctx);
+	if (!has_audio) {
+		error = "No supported audio stream found";
 		return false;
 	}
 
-	output.clear();
+	return true;
+}
 
-	// Read and decode packets
-	while (av_read_frame(format_ctx, packet) >= 0) {
-		if (packet->stream_index == audio_stream_idx) {
-			if (avcodec_send_packet(codec_ctx, packet) >= 0) {
-				while (avcodec_receive_frame(codec_ctx, frame) >= 0) {
-					// Calculate output samples
-					int64_t delay = swr_get_delay(swr_ctx, codec_ctx->sample_rate);
-					int64_t out_samples = av_rescale_rnd(delay + frame->nb_samples, WHISPER_SAMPLE_RATE,
-					                                     codec_ctx->sample_rate, AV_ROUND_UP);
-
-					std::vector<float> buffer(out_samples);
-					uint8_t *out_buf = reinterpret_cast<uint8_t *>(buffer.data());
-
-					int samples_converted =
-					    swr_convert(swr_ctx, &out_buf, out_samples, const_cast<const uint8_t **>(frame->extended_data),
-					                frame->nb_samples);
-
-					if (samples_converted > 0) {
-						output.insert(output.end(), buffer.begin(), buffer.begin() + samples_converted);
-					}
-				}
-			}
+// ============================================================================
+// AudioStreamReader
+// ============================================================================
+
+// Stream parameters that determine how a decoder and resampler are configured
+struct DecoderKey {
+	AVCodecID codec_id = AV_CODEC_ID_NONE;
+	int sample_rate = 0;
+	int channels = 0;
+	uint64_t channel_layout = 0;
+	int format = -1;
+	int block_align = 0;
+	int bits_per_coded_sample = 0;
+	std::vector<uint8_t> extradata;
+
+	explicit DecoderKey(const AVCodecParameters *codecpar = nullptr) {
+		if (!codecpar) {
+			return;
+		}
+		codec_id = codecpar->codec_id;
+		sample_rate = codecpar->sample_rate;
+#if FFMPEG_NEW_CHANNEL_API
+		channels = codecpar->ch_layout.nb_channels;
+		channel_layout = codecpar->ch_layout.order == AV_CHANNEL_ORDER_NATIVE ? codecpar->ch_layout.u.mask : 0;
+#else
+		channels = codecpar->channels;
+		channel_layout = codecpar->channel_layout;
+#endif
+		format = codecpar->format;
+		block_align = codecpar->block_align;
+		bits_per_coded_sample = codecpar->bits_per_coded_sample;
+		if (codecpar->extradata && codecpar->extradata_size > 0) {
+			extradata.assign(codecpar->extradata, codecpar->extradata + codecpar->extradata_size);
 		}
-		av_packet_unref(packet);
 	}
 
-	// Flush decoder
-	avcodec_send_packet(codec_ctx, nullptr);
-	while (avcodec_receive_frame(codec_ctx, frame) >= 0) {
-		int64_t delay = swr_get_delay(swr_ctx, codec_ctx->sample_rate);
-		int64_t out_samples =
-		    av_rescale_rnd(delay + frame->nb_samples, WHISPER_SAMPLE_RATE, codec_ctx->sample_rate, AV_ROUND_UP);
+	bool operator==(const DecoderKey &other) const {
+		return codec_id == other.codec_id && sample_rate == other.sample_rate && channels == other.channels &&
+		       channel_layout == other.channel_layout && format == other.format && block_align == other.block_align &&
+		       bits_per_coded_sample == other.bits_per_coded_sample && extradata == other.extradata;
+	}
+};
 
-		std::vector<float> buffer(out_samples);
-		uint8_t *out_buf = reinterpret_cast<uint8_t *>(buffer.data());
+// FFmpeg objects kept per thread and reused by successive decodes. Batch jobs over many short clips
+// of the same codec reuse the opened decoder and resampler (flushed, not freed) instead of rebuilding them.
+// Decodes run on long-lived threads (the engine's worker pool or DuckDB's own pipeline threads), so the
+// scratch carries over from one DataChunk and query to the next.
+struct DecoderScratch {
+	AVPacket *packet = nullptr;
+	AVFrame *frame = nullptr;
 
-		int samples_converted = swr_convert(swr_ctx, &out_buf, out_samples,
-		                                    const_cast<const uint8_t **>(frame->extended_data), frame->nb_samples);
+	// Most recently used decoder, ready to accept a new stream with matching parameters
+	AVCodecContext *codec_ctx = nullptr;
+	SwrContext *swr_ctx = nullptr;
+	DecoderKey key;
 
-		if (samples_converted > 0) {
-			output.insert(output.end(), buffer.begin(), buffer.begin() + samples_converted);
+	void ReleaseDecoder() {
+		if (codec_ctx) {
+			avcodec_free_context(&codec_ctx);
+		}
+		if (swr_ctx) {
+			swr_free(&swr_ctx);
 		}
 	}
 
-	// Flush resampler
-	int64_t delay = swr_get_delay(swr_ctx, WHISPER_SAMPLE_RATE);
-	if (delay > 0) {
-		std::vector<float> buffer(delay);
-		uint8_t *out_buf = reinterpret_cast<uint8_t *>(buffer.data());
-		int samples_converted = swr_convert(swr_ctx, &out_buf, delay, nullptr, 0);
-		if (samples_converted > 0) {
-			output.insert(output.end(), buffer.begin(), buffer.begin() + samples_converted);
+	~DecoderScratch() {
+		if (packet) {
+			av_packet_free(&packet);
+		}
+		if (frame) {
+			av_frame_free(&frame);
 		}
+		ReleaseDecoder();
 	}
+};
 
-	// Cleanup
-	av_packet_free(&packet);
-	av_frame_free(&frame);
-	swr_free(&swr_ctx);
-	avcodec_free_context(&codec_ctx);
-	avformat_close_input(&format_ctx);
+static thread_local DecoderScratch decoder_scratch;
 
-	return true;
-}
+struct AudioStreamReader::Impl {
+	// In-memory input state for the custom AVIO context
+	struct BufferData {
+		const uint8_t *ptr;
+		size_t size;
+		size_t pos;
+	};
 
-bool AudioUtils::LoadAudioFromMemory(const uint8_t *data, size_t size, std::vector<float> &output, std::string &error) {
-	// For memory loading, we use a custom AVIOContext
 	AVFormatContext *format_ctx = nullptr;
+	AVIOContext *avio_ctx = nullptr;
 	AVCodecContext *codec_ctx = nullptr;
 	SwrContext *swr_ctx = nullptr;
 	AVPacket *packet = nullptr;
 	AVFrame *frame = nullptr;
-	AVIOContext *avio_ctx = nullptr;
 	int audio_stream_idx = -1;
+	BufferData buffer_data = {nullptr, 0, 0};
 
-	// Create buffer for AVIO
-	const size_t avio_buffer_size = 4096;
-	uint8_t *avio_buffer = static_cast<uint8_t *>(av_malloc(avio_buffer_size));
-	if (!avio_buffer) {
-		error = "Failed to allocate AVIO buffer";
-		return false;
+	// Parameters the decoder was opened with (set once it can be handed back for reuse)
+	DecoderKey decoder_key;
+	bool decoder_ready = false;
+
+	// Converted samples not yet returned by Read
+	std::vector<float> pending;
+	size_t pending_pos = 0;
+
+	// Where Convert appends resampled audio (pending, or the caller's buffer in ReadAll)
+	std::vector<float> *sink = &pending;
+
+	bool input_eof = false;
+	bool decoder_eof = false;
+	double duration = 0.0;
+
+	// After Seek: decoded audio before this time (in seconds) is dropped
+	double skip_until = -1.0;
+
+	Impl() {
+		// Borrow this thread's cached packet and frame (handed back on destruction)
+		std::swap(packet, decoder_scratch.packet);
+		std::swap(frame, decoder_scratch.frame);
 	}
 
-	// Structure to hold buffer state
-	struct BufferData {
-		const uint8_t *ptr;
-		size_t size;
-		size_t pos;
-	};
+	~Impl() {
+		if (packet) {
+			av_packet_unref(packet);
+			if (!decoder_scratch.packet) {
+				std::swap(packet, decoder_scratch.packet);
+			} else {
+				av_packet_free(&packet);
+			}
+		}
+		if (frame) {
+			av_frame_unref(frame);
+			if (!decoder_scratch.frame) {
+				std::swap(frame, decoder_scratch.frame);
+			} else {
+				av_frame_free(&frame);
+			}
+		}
+		if (decoder_ready) {
+			ReturnDecoder();
+		}
+		if (codec_ctx) {
+			avcodec_free_context(&codec_ctx);
+		}
+		if (swr_ctx) {
+			swr_free(&swr_ctx);
+		}
+		if (format_ctx) {
+			avformat_close_input(&format_ctx);
+		}
+		if (avio_ctx) {
+			av_free(avio_ctx->buffer);
+			avio_context_free(&avio_ctx);
+		}
+	}
 
-	BufferData buffer_data = {data, size, 0};
+	// Reset the decoder and resampler and park them in the thread cache
+	void ReturnDecoder() {
+		avcodec_flush_buffers(codec_ctx);
+		if (!decoder_eof && swr_init(swr_ctx) < 0) {
+			// Resampler still holds buffered samples and could not be reset
+			return;
+		}
+		decoder_scratch.ReleaseDecoder();
+		std::swap(codec_ctx, decoder_scratch.codec_ctx);
+		std::swap(swr_ctx, decoder_scratch.swr_ctx);
+		decoder_scratch.key = std::move(decoder_key);
+	}
 
-	// Custom read function
-	auto read_packet = [](void *opaque, uint8_t *buf, int buf_size) -> int {
+	static int ReadPacket(void *opaque, uint8_t *buf, int buf_size) {
 		BufferData *bd = static_cast<BufferData *>(opaque);
 		size_t remaining = bd->size - bd->pos;
 		if (remaining == 0)
@@ -256,10 +320,9 @@ bool AudioUtils::LoadAudioFromMemory(const uint8_t *data, size_t size, std::vect
 		memcpy(buf, bd->ptr + bd->pos, to_read);
 		bd->pos += to_read;
 		return static_cast<int>(to_read);
-	};
+	}
 
-	// Custom seek function
-	auto seek_packet = [](void *opaque, int64_t offset, int whence) -> int64_t {
+	static int64_t SeekPacket(void *opaque, int64_t offset, int whence) {
 		BufferData *bd = static_cast<BufferData *>(opaque);
 		int64_t new_pos;
 		switch (whence) {
@@ -282,307 +345,432 @@ bool AudioUtils::LoadAudioFromMemory(const uint8_t *data, size_t size, std::vect
 		}
 		bd->pos = new_pos;
 		return new_pos;
-	};
+	}
 
-	avio_ctx = avio_alloc_context(avio_buffer, avio_buffer_size, 0, &buffer_data, read_packet, nullptr, seek_packet);
-	if (!avio_ctx) {
-		av_free(avio_buffer);
-		error = "Failed to allocate AVIO context";
-		return false;
+	// Resolve a container format hint (empty = probe the input)
+	static bool FindInputFormat(const std::string &format, FFmpegInputFormat *&input_format, std::string &error) {
+		input_format = nullptr;
+		if (format.empty()) {
+			return true;
+		}
+		input_format = av_find_input_format(format.c_str());
+		if (!input_format) {
+			error = "Unknown input format: " + format;
+			return false;
+		}
+		return true;
 	}
 
-	format_ctx = avformat_alloc_context();
-	if (!format_ctx) {
-		av_free(avio_ctx->buffer);
-		avio_context_free(&avio_ctx);
-		error = "Failed to allocate format context";
+	// Whether the container header alone describes the audio stream (no need to decode frames to probe it)
+	static bool HasStreamParameters(const AVFormatContext *ctx) {
+		for (unsigned int i = 0; i < ctx->nb_streams; i++) {
+			const AVCodecParameters *codecpar = ctx->streams[i]->codecpar;
+			if (codecpar->codec_type != AVMEDIA_TYPE_AUDIO) {
+				continue;
+			}
+#if FFMPEG_NEW_CHANNEL_API
+			int channels = codecpar->ch_layout.nb_channels;
+#else
+			int channels = codecpar->channels;
+#endif
+			return codecpar->codec_id != AV_CODEC_ID_NONE && codecpar->sample_rate > 0 && channels > 0;
+		}
 		return false;
 	}
 
-	format_ctx->pb = avio_ctx;
+	// Open a new decoder and resampler for the given stream parameters
+	bool CreateDecoder(const AVCodecParameters *codecpar, std::string &error) {
+		const AVCodec *codec = avcodec_find_decoder(codecpar->codec_id);
+		if (!codec) {
+			error = "Unsupported audio codec";
+			return false;
+		}
 
-	if (avformat_open_input(&format_ctx, nullptr, nullptr, nullptr) < 0) {
-		error = "Failed to open audio from memory";
-		av_free(avio_ctx->buffer);
-		avio_context_free(&avio_ctx);
-		return false;
-	}
+		codec_ctx = avcodec_alloc_context3(codec);
+		if (!codec_ctx) {
+			error = "Failed to allocate codec context";
+			return false;
+		}
 
-	// From here, similar to LoadAudioFile
-	if (avformat_find_stream_info(format_ctx, nullptr) < 0) {
-		error = "Failed to find stream info";
-		avformat_close_input(&format_ctx);
-		av_free(avio_ctx->buffer);
-		avio_context_free(&avio_ctx);
-		return false;
-	}
+		if (avcodec_parameters_to_context(codec_ctx, codecpar) < 0) {
+			error = "Failed to copy codec parameters";
+			return false;
+		}
 
-	for (unsigned int i = 0; i < format_ctx->nb_streams; i++) {
-		if (format_ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
-			audio_stream_idx = i;
-			break;
+		if (avcodec_open2(codec_ctx, codec, nullptr) < 0) {
+			error = "Failed to open codec";
+			return false;
 		}
-	}
 
-	if (audio_stream_idx < 0) {
-		error = "No audio stream found in data";
-		avformat_close_input(&format_ctx);
-		av_free(avio_ctx->buffer);
-		avio_context_free(&avio_ctx);
-		return false;
-	}
+#if FFMPEG_NEW_CHANNEL_API
+		AVChannelLayout out_ch_layout = AV_CHANNEL_LAYOUT_MONO;
+		AVChannelLayout in_ch_layout;
+
+		if (codec_ctx->ch_layout.nb_channels > 0) {
+			av_channel_layout_copy(&in_ch_layout, &codec_ctx->ch_layout);
+		} else {
+			av_channel_layout_default(&in_ch_layout,
+			                          codecpar->ch_layout.nb_channels > 0 ? codecpar->ch_layout.nb_channels : 2);
+		}
 
-	AVCodecParameters *codecpar = format_ctx->streams[audio_stream_idx]->codecpar;
-	const AVCodec *codec = avcodec_find_decoder(codecpar->codec_id);
-	if (!codec) {
-		error = "Unsupported audio codec";
-		avformat_close_input(&format_ctx);
-		av_free(avio_ctx->buffer);
-		avio_context_free(&avio_ctx);
-		return false;
-	}
+		swr_alloc_set_opts2(&swr_ctx, &out_ch_layout, AV_SAMPLE_FMT_FLT, WHISPER_SAMPLE_RATE, &in_ch_layout,
+		                    codec_ctx->sample_fmt, codec_ctx->sample_rate, 0, nullptr);
+		av_channel_layout_uninit(&in_ch_layout);
+#else
+		// Legacy FFmpeg API (< 5.1)
+		int64_t in_channel_layout = codec_ctx->channel_layout;
+		int in_channels = codec_ctx->channels;
 
-	codec_ctx = avcodec_alloc_context3(codec);
-	if (!codec_ctx) {
-		error = "Failed to allocate codec context";
-		avformat_close_input(&format_ctx);
-		av_free(avio_ctx->buffer);
-		avio_context_free(&avio_ctx);
-		return false;
-	}
+		if (in_channel_layout == 0) {
+			in_channel_layout = av_get_default_channel_layout(in_channels > 0 ? in_channels : 2);
+		}
 
-	if (avcodec_parameters_to_context(codec_ctx, codecpar) < 0) {
-		error = "Failed to copy codec parameters";
-		avcodec_free_context(&codec_ctx);
-		avformat_close_input(&format_ctx);
-		av_free(avio_ctx->buffer);
-		avio_context_free(&avio_ctx);
-		return false;
-	}
+		swr_ctx = swr_alloc_set_opts(nullptr, AV_CH_LAYOUT_MONO, AV_SAMPLE_FMT_FLT, WHISPER_SAMPLE_RATE,
+		                             in_channel_layout, codec_ctx->sample_fmt, codec_ctx->sample_rate, 0, nullptr);
+#endif
 
-	if (avcodec_open2(codec_ctx, codec, nullptr) < 0) {
-		error = "Failed to open codec";
-		avcodec_free_context(&codec_ctx);
-		avformat_close_input(&format_ctx);
-		av_free(avio_ctx->buffer);
-		avio_context_free(&avio_ctx);
-		return false;
+		if (!swr_ctx || swr_init(swr_ctx) < 0) {
+			error = "Failed to initialize resampler";
+			return false;
+		}
+		return true;
 	}
 
-#if FFMPEG_NEW_CHANNEL_API
-	AVChannelLayout out_ch_layout = AV_CHANNEL_LAYOUT_MONO;
-	AVChannelLayout in_ch_layout;
+	// Set up decoder and resampler after the format context has been opened
+	bool OpenDecoder(const char *source, bool format_hinted, std::string &error) {
+		// With a format hint, header-only containers (e.g. WAV) skip the probing decode
+		if (!(format_hinted && HasStreamParameters(format_ctx)) && avformat_find_stream_info(format_ctx, nullptr) < 0) {
+			error = "Failed to find stream info";
+			return false;
+		}
 
-	if (codec_ctx->ch_layout.nb_channels > 0) {
-		av_channel_layout_copy(&in_ch_layout, &codec_ctx->ch_layout);
-	} else {
-		av_channel_layout_default(&in_ch_layout,
-		                          codecpar->ch_layout.nb_channels > 0 ? codecpar->ch_layout.nb_channels : 2);
-	}
+		for (unsigned int i = 0; i < format_ctx->nb_streams; i++) {
+			if (format_ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
+				audio_stream_idx = i;
+				break;
+			}
+		}
 
-	swr_alloc_set_opts2(&swr_ctx, &out_ch_layout, AV_SAMPLE_FMT_FLT, WHISPER_SAMPLE_RATE, &in_ch_layout,
-	                    codec_ctx->sample_fmt, codec_ctx->sample_rate, 0, nullptr);
+		if (audio_stream_idx < 0) {
+			error = std::string("No audio stream found in ") + source;
+			return false;
+		}
 
-	if (!swr_ctx || swr_init(swr_ctx) < 0) {
-		error = "Failed to initialize resampler";
-		av_channel_layout_uninit(&in_ch_layout);
-		avcodec_free_context(&codec_ctx);
-		avformat_close_input(&format_ctx);
-		av_free(avio_ctx->buffer);
-		avio_context_free(&avio_ctx);
-		return false;
-	}
+		AVStream *stream = format_ctx->streams[audio_stream_idx];
+		if (format_ctx->duration > 0) {
+			duration = static_cast<double>(format_ctx->duration) / AV_TIME_BASE;
+		} else if (stream->duration > 0) {
+			duration = static_cast<double>(stream->duration) * av_q2d(stream->time_base);
+		}
 
-	av_channel_layout_uninit(&in_ch_layout);
-#else
-	// Legacy FFmpeg API (< 5.1)
-	int64_t in_channel_layout = codec_ctx->channel_layout;
-	int in_channels = codec_ctx->channels;
+		// Reuse this thread's decoder when the stream parameters match; otherwise open a new one
+		AVCodecParameters *codecpar = stream->codecpar;
+		decoder_key = DecoderKey(codecpar);
+		if (decoder_scratch.codec_ctx && decoder_scratch.key == decoder_key) {
+			std::swap(codec_ctx, decoder_scratch.codec_ctx);
+			std::swap(swr_ctx, decoder_scratch.swr_ctx);
+		} else if (!CreateDecoder(codecpar, error)) {
+			return false;
+		}
+		codec_ctx->pkt_timebase = stream->time_base;
+		decoder_ready = true;
 
-	if (in_channel_layout == 0) {
-		in_channel_layout = av_get_default_channel_layout(in_channels > 0 ? in_channels : 2);
-	}
-	if (in_channels == 0) {
-		in_channels = av_get_channel_layout_nb_channels(in_channel_layout);
+		if (!packet) {
+			packet = av_packet_alloc();
+		}
+		if (!frame) {
+			frame = av_frame_alloc();
+		}
+		if (!packet || !frame) {
+			error = "Failed to allocate packet/frame";
+			return false;
+		}
+
+		return true;
 	}
 
-	swr_ctx = swr_alloc_set_opts(nullptr, AV_CH_LAYOUT_MONO, AV_SAMPLE_FMT_FLT, WHISPER_SAMPLE_RATE, in_channel_layout,
-	                             codec_ctx->sample_fmt, codec_ctx->sample_rate, 0, nullptr);
+	// Resample directly into the tail of the sink buffer
+	void Convert(const uint8_t **in_data, int in_samples) {
+		int64_t delay = swr_get_delay(swr_ctx, codec_ctx->sample_rate);
+		int64_t out_samples =
+		    av_rescale_rnd(delay + in_samples, WHISPER_SAMPLE_RATE, codec_ctx->sample_rate, AV_ROUND_UP);
+		if (out_samples <= 0) {
+			return;
+		}
 
-	if (!swr_ctx || swr_init(swr_ctx) < 0) {
-		error = "Failed to initialize resampler";
-		avcodec_free_context(&codec_ctx);
-		avformat_close_input(&format_ctx);
-		av_free(avio_ctx->buffer);
-		avio_context_free(&avio_ctx);
-		return false;
+		auto &out = *sink;
+		size_t old_size = out.size();
+		out.resize(old_size + out_samples);
+		uint8_t *out_buf = reinterpret_cast<uint8_t *>(out.data() + old_size);
+
+		int samples_converted = swr_convert(swr_ctx, &out_buf, static_cast<int>(out_samples), in_data, in_samples);
+		out.resize(old_size + (samples_converted > 0 ? samples_converted : 0));
 	}
-#endif
 
-	packet = av_packet_alloc();
-	frame = av_frame_alloc();
+	// Convert a decoded frame, dropping what lies before skip_until
+	void ConvertFrame() {
+		if (skip_until < 0.0) {
+			Convert(const_cast<const uint8_t **>(frame->extended_data), frame->nb_samples);
+			return;
+		}
+		if (frame->best_effort_timestamp == AV_NOPTS_VALUE) {
+			// Without timestamps the position is unknown; keep everything from here on
+			skip_until = -1.0;
+			Convert(const_cast<const uint8_t **>(frame->extended_data), frame->nb_samples);
+			return;
+		}
 
-	if (!packet || !frame) {
-		error = "Failed to allocate packet/frame";
-		if (packet)
-			av_packet_free(&packet);
-		if (frame)
-			av_frame_free(&frame);
-		swr_free(&swr_ctx);
-		avcodec_free_context(&codec_ctx);
-		avformat_close_input(&format_ctx);
-		av_free(avio_ctx->buffer);
-		avio_context_free(&avio_ctx);
-		return false;
-	}
+		// Positions are relative to the stream start, like the sample offsets of a full decode
+		AVStream *stream = format_ctx->streams[audio_stream_idx];
+		int64_t pts = frame->best_effort_timestamp;
+		if (stream->start_time != AV_NOPTS_VALUE) {
+			pts -= stream->start_time;
+		}
+		double frame_start = static_cast<double>(pts) * av_q2d(stream->time_base);
+		double frame_end = frame_start + static_cast<double>(frame->nb_samples) / codec_ctx->sample_rate;
+		if (frame_end <= skip_until) {
+			return;
+		}
 
-	output.clear();
+		// The frame straddles the target: convert it and cut the resampled head
+		auto &out = *sink;
+		size_t old_size = out.size();
+		Convert(const_cast<const uint8_t **>(frame->extended_data), frame->nb_samples);
+		auto drop = static_cast<size_t>(std::max(skip_until - frame_start, 0.0) * WHISPER_SAMPLE_RATE);
+		drop = std::min(drop, out.size() - old_size);
+		out.erase(out.begin() + old_size, out.begin() + old_size + drop);
+		skip_until = -1.0;
+	}
+
+	// Decode the next frame into the pending buffer; returns false once the stream is exhausted
+	bool DecodeMore() {
+		while (!decoder_eof) {
+			int ret = avcodec_receive_frame(codec_ctx, frame);
+			if (ret >= 0) {
+				ConvertFrame();
+				return true;
+			}
+			if (ret != AVERROR(EAGAIN)) {
+				// Decoder fully drained, flush the resampler
+				decoder_eof = true;
+				Convert(nullptr, 0);
+				return true;
+			}
 
-	while (av_read_frame(format_ctx, packet) >= 0) {
-		if (packet->stream_index == audio_stream_idx) {
-			if (avcodec_send_packet(codec_ctx, packet) >= 0) {
-				while (avcodec_receive_frame(codec_ctx, frame) >= 0) {
-					int64_t delay = swr_get_delay(swr_ctx, codec_ctx->sample_rate);
-					int64_t out_samples = av_rescale_rnd(delay + frame->nb_samples, WHISPER_SAMPLE_RATE,
-					                                     codec_ctx->sample_rate, AV_ROUND_UP);
-
-					std::vector<float> buffer(out_samples);
-					uint8_t *out_buf = reinterpret_cast<uint8_t *>(buffer.data());
-
-					int samples_converted =
-					    swr_convert(swr_ctx, &out_buf, out_samples, const_cast<const uint8_t **>(frame->extended_data),
-					                frame->nb_samples);
-
-					if (samples_converted > 0) {
-						output.insert(output.end(), buffer.begin(), buffer.begin() + samples_converted);
-					}
-				}
+			// Decoder needs more input
+			if (input_eof) {
+				decoder_eof = true;
+				Convert(nullptr, 0);
+				return true;
+			}
+			if (av_read_frame(format_ctx, packet) < 0) {
+				input_eof = true;
+				avcodec_send_packet(codec_ctx, nullptr);
+				continue;
+			}
+			if (packet->stream_index == audio_stream_idx) {
+				avcodec_send_packet(codec_ctx, packet);
 			}
+			av_packet_unref(packet);
 		}
-		av_packet_unref(packet);
+		return false;
 	}
+};
 
-	avcodec_send_packet(codec_ctx, nullptr);
-	while (avcodec_receive_frame(codec_ctx, frame) >= 0) {
-		int64_t delay = swr_get_delay(swr_ctx, codec_ctx->sample_rate);
-		int64_t out_samples =
-		    av_rescale_rnd(delay + frame->nb_samples, WHISPER_SAMPLE_RATE, codec_ctx->sample_rate, AV_ROUND_UP);
-
-		std::vector<float> buffer(out_samples);
-		uint8_t *out_buf = reinterpret_cast<uint8_t *>(buffer.data());
+AudioStreamReader::AudioStreamReader() : impl_(new Impl()) {
+}
 
-		int samples_converted = swr_convert(swr_ctx, &out_buf, out_samples,
-		                                    const_cast<const uint8_t **>(frame->extended_data), frame->nb_samples);
+AudioStreamReader::~AudioStreamReader() {
+}
 
-		if (samples_converted > 0) {
-			output.insert(output.end(), buffer.begin(), buffer.begin() + samples_converted);
-		}
+bool AudioStreamReader::OpenFile(const std::string &file_path, const std::string &format, std::string &error) {
+	FFmpegInputFormat *input_format;
+	if (!Impl::FindInputFormat(format, input_format, error)) {
+		return false;
+	}
+	if (avformat_open_input(&impl_->format_ctx, file_path.c_str(), input_format, nullptr) < 0) {
+		error = "Failed to open audio file: " + file_path;
+		return false;
 	}
+	return impl_->OpenDecoder("file", input_format != nullptr, error);
+}
 
-	int64_t delay = swr_get_delay(swr_ctx, WHISPER_SAMPLE_RATE);
-	if (delay > 0) {
-		std::vector<float> buffer(delay);
-		uint8_t *out_buf = reinterpret_cast<uint8_t *>(buffer.data());
-		int samples_converted = swr_convert(swr_ctx, &out_buf, delay, nullptr, 0);
-		if (samples_converted > 0) {
-			output.insert(output.end(), buffer.begin(), buffer.begin() + samples_converted);
-		}
+bool AudioStreamReader::OpenMemory(const uint8_t *data, size_t size, const std::string &format, std::string &error) {
+	FFmpegInputFormat *input_format;
+	if (!Impl::FindInputFormat(format, input_format, error)) {
+		return false;
 	}
 
-	av_packet_free(&packet);
-	av_frame_free(&frame);
-	swr_free(&swr_ctx);
-	avcodec_free_context(&codec_ctx);
-	avformat_close_input(&format_ctx);
-	av_free(avio_ctx->buffer);
-	avio_context_free(&avio_ctx);
+	const size_t avio_buffer_size = GetAvioBufferSize(size);
+	uint8_t *avio_buffer = static_cast<uint8_t *>(av_malloc(avio_buffer_size));
+	if (!avio_buffer) {
+		error = "Failed to allocate AVIO buffer";
+		return false;
+	}
 
-	return true;
-}
+	impl_->buffer_data = {data, size, 0};
+	impl_->avio_ctx = avio_alloc_context(avio_buffer, avio_buffer_size, 0, &impl_->buffer_data, Impl::ReadPacket,
+	                                     nullptr, Impl::SeekPacket);
+	if (!impl_->avio_ctx) {
+		av_free(avio_buffer);
+		error = "Failed to allocate AVIO context";
+		return false;
+	}
 
-bool AudioUtils::GetAudioMetadata(const std::string &file_path, AudioMetadata &metadata, std::string &error) {
-	AVFormatContext *format_ctx = nullptr;
+	impl_->format_ctx = avformat_alloc_context();
+	if (!impl_->format_ctx) {
+		error = "Failed to allocate format context";
+		return false;
+	}
+	impl_->format_ctx->pb = impl_->avio_ctx;
 
-	if (avformat_open_input(&format_ctx, file_path.c_str(), nullptr, nullptr) < 0) {
-		error = "Failed to open audio file: " + file_path;
+	// avformat_open_input frees the format context on failure
+	if (avformat_open_input(&impl_->format_ctx, nullptr, input_format, nullptr) < 0) {
+		error = "Failed to open audio from memory";
 		return false;
 	}
+	return impl_->OpenDecoder("data", input_format != nullptr, error);
+}
 
-	if (avformat_find_stream_info(format_ctx, nullptr) < 0) {
-		error = "Failed to find stream info";
-		avformat_close_input(&format_ctx);
+bool AudioStreamReader::Read(std::vector<float> &output, size_t max_samples, std::string &error) {
+	if (!impl_->codec_ctx || !impl_->swr_ctx || !impl_->packet || !impl_->frame) {
+		error = "Audio stream is not open";
 		return false;
 	}
 
-	int audio_stream_idx = -1;
-	for (unsigned int i = 0; i < format_ctx->nb_streams; i++) {
-		if (format_ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
-			audio_stream_idx = i;
+	size_t added = 0;
+	while (added < max_samples) {
+		size_t available = impl_->pending.size() - impl_->pending_pos;
+		if (available > 0) {
+			size_t to_copy = std::min(available, max_samples - added);
+			auto begin = impl_->pending.begin() + impl_->pending_pos;
+			output.insert(output.end(), begin, begin + to_copy);
+			impl_->pending_pos += to_copy;
+			added += to_copy;
+			continue;
+		}
+
+		// Pending buffer consumed, reuse its allocation for the next frame
+		impl_->pending.clear();
+		impl_->pending_pos = 0;
+		if (!impl_->DecodeMore()) {
 			break;
 		}
 	}
+	return true;
+}
 
-	if (audio_stream_idx < 0) {
-		error = "No audio stream found in file";
-		avformat_close_input(&format_ctx);
+bool AudioStreamReader::ReadAll(std::vector<float> &output, std::string &error) {
+	if (!impl_->codec_ctx || !impl_->swr_ctx || !impl_->packet || !impl_->frame) {
+		error = "Audio stream is not open";
 		return false;
 	}
 
-	AVStream *stream = format_ctx->streams[audio_stream_idx];
-	AVCodecParameters *codecpar = stream->codecpar;
-
-	metadata.duration_seconds =
-	    format_ctx->duration > 0 ? static_cast<double>(format_ctx->duration) / AV_TIME_BASE : 0.0;
-	metadata.sample_rate = codecpar->sample_rate;
-#if FFMPEG_NEW_CHANNEL_API
-	metadata.channels = codecpar->ch_layout.nb_channels;
-#else
-	metadata.channels = codecpar->channels;
-#endif
-	metadata.format = format_ctx->iformat->name;
+	// Pre-size from the container duration (plus slack for resampler rounding) so output is not regrown
+	output.clear();
+	if (impl_->duration > 0) {
+		output.reserve(static_cast<size_t>(impl_->duration * WHISPER_SAMPLE_RATE) + WHISPER_SAMPLE_RATE);
+	}
 
-	// Get file size
-	std::ifstream file(file_path, std::ios::binary | std::ios::ate);
-	metadata.file_size = file.is_open() ? static_cast<int64_t>(file.tellg()) : 0;
+	// Hand over anything Read already buffered, then resample straight into output
+	output.insert(output.end(), impl_->pending.begin() + impl_->pending_pos, impl_->pending.end());
+	impl_->pending.clear();
+	impl_->pending_pos = 0;
 
-	avformat_close_input(&format_ctx);
+	impl_->sink = &output;
+	while (impl_->DecodeMore()) {
+	}
+	impl_->sink = &impl_->pending;
 	return true;
 }
 
-bool AudioUtils::CheckAudioFile(const std::string &file_path, std::string &error) {
-	AVFormatContext *format_ctx = nullptr;
+void AudioStreamReader::Seek(double seconds) {
+	if (!impl_->format_ctx || !impl_->codec_ctx || seconds <= 0.0) {
+		return;
+	}
 
-	if (avformat_open_input(&format_ctx, file_path.c_str(), nullptr, nullptr) < 0) {
-		error = "Cannot open file or unsupported format";
-		return false;
+	// Land on the last seek point at or before the target; ConvertFrame drops the rest
+	auto target = static_cast<int64_t>(seconds * AV_TIME_BASE);
+	if (avformat_seek_file(impl_->format_ctx, -1, INT64_MIN, target, target, AVSEEK_FLAG_BACKWARD) >= 0) {
+		avcodec_flush_buffers(impl_->codec_ctx);
+		swr_init(impl_->swr_ctx);
 	}
+	impl_->pending.clear();
+	impl_->pending_pos = 0;
+	impl_->input_eof = false;
+	impl_->decoder_eof = false;
+	impl_->skip_until = seconds;
+}
 
-	if (avformat_find_stream_info(format_ctx, nullptr) < 0) {
-		error = "Cannot read stream info";
-		avformat_close_input(&format_ctx);
+bool AudioStreamReader::IsFinished() const {
+	return impl_->decoder_eof && impl_->pending_pos >= impl_->pending.size();
+}
+
+double AudioStreamReader::GetDuration() const {
+	return impl_->duration;
+}
+
+// ============================================================================
+// One-shot loading
+// ============================================================================
+
+bool AudioUtils::LoadAudioFile(const std::string &file_path, const std::string &format, std::vector<float> &output,
+                               std::string &error) {
+	// 16kHz mono PCM WAV is already whisper's input format and needs no decoding or resampling
+	if ((format.empty() || format == "wav") && WavReader::LoadFile(file_path, output)) {
+		return true;
+	}
+
+	AudioStreamReader reader;
+	if (!reader.OpenFile(file_path, format, error)) {
 		return false;
 	}
+	return reader.ReadAll(output, error);
+}
 
-	bool has_audio = false;
-	for (unsigned int i = 0; i < format_ctx->nb_streams; i++) {
-		if (format_ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
-			AVCodecParameters *codecpar = format_ctx->streams[i]->codecpar;
-			const AVCodec *codec = avcodec_find_decoder(codecpar->codec_id);
-			if (codec) {
-				has_audio = true;
-				break;
-			}
-		}
+bool AudioUtils::LoadAudioFromMemory(const uint8_t *data, size_t size, const std::string &format,
+                                     std::vector<float> &output, std::string &error) {
+	if ((format.empty() || format == "wav") && WavReader::LoadMemory(data, size, output)) {
+		return true;
 	}
 
-	avformat_close_input(&format_ctx);
+	AudioStreamReader reader;
+	if (!reader.OpenMemory(data, size, format, error)) {
+		return false;
+	}
+	return reader.ReadAll(output, error);
+}
 
-	if (!has_audio) {
-		error = "No supported audio stream found";
+static bool ReadRange(AudioStreamReader &reader, double start_seconds, double end_seconds,
+                      std::vector<float> &output, std::string &error) {
+	reader.Seek(start_seconds);
+	if (end_seconds < 0.0) {
+		return reader.ReadAll(output, error);
+	}
+	output.clear();
+	double seconds = std::max(end_seconds - std::max(start_seconds, 0.0), 0.0);
+	auto n_samples = static_cast<size_t>(seconds * WHISPER_SAMPLE_RATE);
+	output.reserve(n_samples);
+	return reader.Read(output, n_samples, error);
+}
+
+bool AudioUtils::LoadAudioFileRange(const std::string &file_path, const std::string &format, double start_seconds,
+                                    double end_seconds, std::vector<float> &output, std::string &error) {
+	AudioStreamReader reader;
+	if (!reader.OpenFile(file_path, format, error)) {
 		return false;
 	}
+	return ReadRange(reader, start_seconds, end_seconds, output, error);
+}
 
-	return true;
+bool AudioUtils::LoadAudioFromMemoryRange(const uint8_t *data, size_t size, const std::string &format,
+                                          double start_seconds, double end_seconds, std::vector<float> &output,
+                                          std::string &error) {
+	AudioStreamReader reader;
+	if (!reader.OpenMemory(data, size, format, error)) {
+		return false;
+	}
+	return ReadRange(reader, start_seconds, end_seconds, output, error);
 }
 
 void AudioUtils::SetFFmpegLogging(bool enabled) {
@@ -5,7 +5,11 @@
 #include "duckdb/common/exception.hpp"
 
 #include "model_manager.hpp"
+#include "transcription_stats.hpp"
 #include "whisper_config.hpp"
+#include "whisper_context.hpp"
+
+#include <chrono>
 
 namespace duckdb {
 
@@ -42,6 +46,12 @@ static unique_ptr<FunctionData> ListModelsBind(ClientContext &context, TableFunc
 	return_types.push_back(LogicalType::VARCHAR); // description
 	names.push_back("description");
 
+	return_types.push_back(LogicalType::BIGINT); // download_size
+	names.push_back("download_size");
+
+	return_types.push_back(LogicalType::VARCHAR); // quantization
+	names.push_back("quantization");
+
 	return nullptr;
 }
 
@@ -64,6 +74,8 @@ static void ListModelsExecute(ClientContext &context, TableFunctionInput &data,
 		output.SetValue(2, output_idx, model.is_downloaded ? Value::BIGINT(model.file_size) : Value());
 		output.SetValue(3, output_idx, Value(model.file_path));
 		output.SetValue(4, output_idx, Value(model.description));
+		output.SetValue(5, output_idx, Value::BIGINT(model.download_size));
+		output.SetValue(6, output_idx, Value(model.quantization));
 
 		state.current_idx++;
 		output_idx++;
@@ -171,6 +183,124 @@ static void ModelInfoExecute(ClientContext &context, TableFunctionInput &data, D
 	state.returned = true;
 }
 
+// ============================================================================
+// whisper_preload_model(model_name) - Scalar function to load a model ahead of use
+// ============================================================================
+
+static void WhisperPreloadModelFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &context = state.GetContext();
+	auto config = WhisperConfigManager::GetConfig(context);
+
+	auto &model_name_vec = args.data[0];
+	idx_t count = args.size();
+
+	UnaryExecutor::Execute<string_t, string_t>(model_name_vec, result, count, [&](string_t model_name_val) {
+		std::string model_name = model_name_val.GetString();
+		std::string error;
+
+		if (!ModelManager::IsValidModelName(model_name)) {
+			throw InvalidInputException("Invalid model name: " + model_name +
+			                            ". Use whisper_list_models() to see available models.");
+		}
+
+		if (!ModelManager::IsModelDownloaded(model_name, config.model_path)) {
+			throw InvalidInputException("Model '" + model_name + "' is not downloaded. Use whisper_download_model('" +
+			                            model_name + "') first.");
+		}
+
+		auto &context_manager = WhisperContextManager::GetInstance();
+		std::string model_path = ModelManager::GetModelPath(model_name, config.model_path);
+		if (context_manager.IsLoaded(model_path, config.use_gpu, config.gpu_device, config.flash_attn)) {
+			return StringVector::AddString(result, "Model '" + model_name + "' is already loaded");
+		}
+
+		idx_t budget_mb = static_cast<idx_t>(MaxValue(config.model_cache_mb, 0));
+		bool loaded = false;
+		auto load_start = std::chrono::steady_clock::now();
+		if (!context_manager.GetContext(model_path, config.use_gpu, config.gpu_device, config.flash_attn, budget_mb,
+		                                error, &loaded)) {
+			throw InvalidInputException("Failed to load model: " + error);
+		}
+		if (loaded) {
+			std::chrono::duration<double, std::milli> load_ms = std::chrono::steady_clock::now() - load_start;
+			TranscriptionStats::GetInstance().RecordModelLoad(model_name, load_ms.count());
+		}
+
+		return StringVector::AddString(result, "Successfully loaded model '" + model_name + "'");
+	});
+}
+
+// ============================================================================
+// whisper_loaded_models() - Table function listing models held in memory
+// ============================================================================
+
+struct LoadedModelsState : public GlobalTableFunctionState {
+	std::vector<LoadedModelInfo> models;
+	idx_t current_idx;
+
+	LoadedModelsState() : current_idx(0) {
+	}
+
+	idx_t MaxThreads() const override {
+		return 1;
+	}
+};
+
+static unique_ptr<FunctionData> LoadedModelsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	return_types.push_back(LogicalType::VARCHAR); // model_path
+	names.push_back("model_path");
+
+	return_types.push_back(LogicalType::BOOLEAN); // use_gpu
+	names.push_back("use_gpu");
+
+	return_types.push_back(LogicalType::INTEGER); // gpu_device (NULL for CPU contexts)
+	names.push_back("gpu_device");
+
+	return_types.push_back(LogicalType::BOOLEAN); // flash_attn
+	names.push_back("flash_attn");
+
+	return_types.push_back(LogicalType::BIGINT); // memory_bytes
+	names.push_back("memory_bytes");
+
+	return_types.push_back(LogicalType::INTEGER); // decoder_states
+	names.push_back("decoder_states");
+
+	return_types.push_back(LogicalType::BOOLEAN); // in_use
+	names.push_back("in_use");
+
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> LoadedModelsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto state = make_uniq<LoadedModelsState>();
+	state->models = WhisperContextManager::GetInstance().ListContexts();
+	return std::move(state);
+}
+
+static void LoadedModelsExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<LoadedModelsState>();
+
+	idx_t output_idx = 0;
+	while (state.current_idx < state.models.size() && output_idx < STANDARD_VECTOR_SIZE) {
+		const auto &model = state.models[state.current_idx];
+
+		output.SetValue(0, output_idx, Value(model.model_path));
+		output.SetValue(1, output_idx, Value::BOOLEAN(model.use_gpu));
+		output.SetValue(2, output_idx,
+		                model.gpu_device < 0 ? Value(LogicalType::INTEGER) : Value::INTEGER(model.gpu_device));
+		output.SetValue(3, output_idx, Value::BOOLEAN(model.flash_attn));
+		output.SetValue(4, output_idx, Value::BIGINT(model.memory_bytes));
+		output.SetValue(5, output_idx, Value::INTEGER(static_cast<int32_t>(model.decoder_states)));
+		output.SetValue(6, output_idx, Value::BOOLEAN(model.in_use));
+
+		state.current_idx++;
+		output_idx++;
+	}
+
+	output.SetCardinality(output_idx);
+}
+
 // ============================================================================
 // Registration
 // ============================================================================
@@ -188,6 +318,15 @@ void RegisterModelFunctions(ExtensionLoader &loader) {
 	// whisper_model_info()
 	TableFunction model_info("whisper_model_info", {}, ModelInfoExecute, ModelInfoBind, ModelInfoInit);
 	loader.RegisterFunction(model_info);
+
+	// whisper_preload_model(model_name)
+	auto preload_func = ScalarFunction("whisper_preload_model", {LogicalType::VARCHAR}, LogicalType::VARCHAR,
+	                                   WhisperPreloadModelFunction);
+	loader.RegisterFunction(preload_func);
+
+	// whisper_loaded_models()
+	TableFunction loaded_models("whisper_loaded_models", {}, LoadedModelsExecute, LoadedModelsBind, LoadedModelsInit);
+	loader.RegisterFunction(loaded_models);
 }
 
 } // namespace duckdb
@@ -7,7 +7,9 @@
 #include "duckdb/common/printer.hpp"
 
 #include "audio_recorder.hpp"
+#include "live_transcriber.hpp"
 #include "transcription_engine.hpp"
+#include "transcription_stats.hpp"
 #include "whisper_config.hpp"
 
 #include <thread>
@@ -117,7 +119,7 @@ static void WhisperRecordFunction(DataChunk &args, ExpressionState &state, Vecto
 		}
 
 		// Record for specified duration
-		std::this_thread::sleep_for(std::chrono::seconds(duration_seconds));
+		recorder.Capture(duration_seconds);
 
 		// Stop and get audio data
 		std::vector<float> pcm_data;
@@ -131,6 +133,7 @@ static void WhisperRecordFunction(DataChunk &args, ExpressionState &state, Vecto
 
 		// Transcribe
 		TranscriptionResult transcription = TranscriptionEngine::TranscribePCM(pcm_data, local_config);
+		TranscriptionStats::SetLastProfile(context, local_config.model, transcription.profile);
 
 		if (!transcription.success) {
 			throw InvalidInputException("Transcription failed: " + transcription.error);
@@ -186,7 +189,7 @@ static void WhisperRecordTranslateFunction(DataChunk &args, ExpressionState &sta
 			Printer::Print(OutputStream::STREAM_STDERR, "Listening...");
 		}
 
-		std::this_thread::sleep_for(std::chrono::seconds(duration_seconds));
+		recorder.Capture(duration_seconds);
 
 		std::vector<float> pcm_data;
 		if (!recorder.StopRecording(pcm_data, error)) {
@@ -198,6 +201,7 @@ static void WhisperRecordTranslateFunction(DataChunk &args, ExpressionState &sta
 		}
 
 		TranscriptionResult transcription = TranscriptionEngine::TranscribePCM(pcm_data, local_config);
+		TranscriptionStats::SetLastProfile(context, local_config.model, transcription.profile);
 
 		if (!transcription.success) {
 			throw InvalidInputException("Translation failed: " + transcription.error);
@@ -236,23 +240,9 @@ static void WhisperMicLevelFunction(DataChunk &args, ExpressionState &state, Vec
 		}
 
 		float max_amplitude = 0.0f;
-		float sum_amplitude = 0.0f;
-		int samples = 0;
 
-		auto start = std::chrono::steady_clock::now();
-		while (true) {
-			std::this_thread::sleep_for(std::chrono::milliseconds(50));
-
-			auto now = std::chrono::steady_clock::now();
-			double elapsed = std::chrono::duration<double>(now - start).count();
-
-			if (elapsed >= duration_seconds)
-				break;
-
-			// This is a simplified check - we'd need to expose amplitude from recorder
-			// For now, we'll record and analyze after
-			samples++;
-		}
+		// Record, then analyze the captured audio
+		recorder.Capture(duration_seconds);
 
 		std::vector<float> pcm_data;
 		recorder.StopRecording(pcm_data, error);
@@ -367,6 +357,7 @@ static void WhisperRecordAutoFunction(DataChunk &args, ExpressionState &state, V
 		}
 
 		TranscriptionResult transcription = TranscriptionEngine::TranscribePCM(pcm_data, local_config);
+		TranscriptionStats::SetLastProfile(context, local_config.model, transcription.profile);
 
 		if (!transcription.success) {
 			throw InvalidInputException("Transcription failed: " + transcription.error);
@@ -376,6 +367,136 @@ static void WhisperRecordAutoFunction(DataChunk &args, ExpressionState &state, V
 	}
 }
 
+// ============================================================================
+// whisper_record_stream(max_seconds, [model]) - Transcribes while recording, emitting segments live
+// ============================================================================
+
+struct RecordStreamBindData : public TableFunctionData {
+	WhisperConfig config;
+	double max_seconds;
+	int device_id;
+	double step;
+	double silence; // Stop this long after speech ends (0 = record for max_seconds)
+	bool partials;  // Also emit unsettled segments (is_final = false), which are emitted again once settled
+};
+
+struct RecordStreamState : public GlobalTableFunctionState {
+	unique_ptr<LiveTranscriber> live;
+	std::vector<LiveSegment> segments;
+	idx_t current_idx;
+	bool finished;
+
+	RecordStreamState() : current_idx(0), finished(false) {
+	}
+
+	idx_t MaxThreads() const override {
+		return 1;
+	}
+};
+
+static unique_ptr<FunctionData> RecordStreamBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	auto bind_data = make_uniq<RecordStreamBindData>();
+	bind_data->config = WhisperConfigManager::GetConfig(context);
+	bind_data->max_seconds = input.inputs[0].GetValue<double>();
+	if (input.inputs.size() > 1 && !input.inputs[1].IsNull()) {
+		bind_data->config.model = input.inputs[1].GetValue<string>();
+	}
+	bind_data->device_id = bind_data->config.device_id;
+	bind_data->step = LiveTranscriber::DEFAULT_STEP_SECONDS;
+	bind_data->silence = 0.0;
+	bind_data->partials = false;
+
+	for (auto &kv : input.named_parameters) {
+		if (kv.first == "device_id") {
+			bind_data->device_id = kv.second.GetValue<int32_t>();
+		} else if (kv.first == "step") {
+			bind_data->step = kv.second.GetValue<double>();
+		} else if (kv.first == "silence") {
+			bind_data->silence = kv.second.GetValue<double>();
+		} else if (kv.first == "partials") {
+			bind_data->partials = kv.second.GetValue<bool>();
+		}
+	}
+	if (bind_data->max_seconds <= 0) {
+		throw InvalidInputException("whisper_record_stream: max_seconds must be positive");
+	}
+
+	return_types.push_back(LogicalType::INTEGER); // segment_id
+	names.push_back("segment_id");
+
+	return_types.push_back(LogicalType::DOUBLE); // start_time
+	names.push_back("start_time");
+
+	return_types.push_back(LogicalType::DOUBLE); // end_time
+	names.push_back("end_time");
+
+	return_types.push_back(LogicalType::VARCHAR); // text
+	names.push_back("text");
+
+	return_types.push_back(LogicalType::DOUBLE); // confidence
+	names.push_back("confidence");
+
+	return_types.push_back(LogicalType::BOOLEAN); // is_final
+	names.push_back("is_final");
+
+	return std::move(bind_data);
+}
+
+static unique_ptr<GlobalTableFunctionState> RecordStreamInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<RecordStreamState>();
+}
+
+static void RecordStreamExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<RecordStreamBindData>();
+	auto &state = data.global_state->Cast<RecordStreamState>();
+
+	if (!state.live) {
+		std::string error;
+		state.live = make_uniq<LiveTranscriber>(bind_data.config, bind_data.step);
+		if (!state.live->Start(bind_data.device_id, bind_data.max_seconds, bind_data.silence, error)) {
+			throw InvalidInputException("Failed to start recording: " + error);
+		}
+		if (bind_data.config.verbose) {
+			Printer::Print(OutputStream::STREAM_STDERR, "Listening...");
+		}
+	}
+
+	// Block until the next step produced segments, so each chunk is returned as soon as it is transcribed
+	while (state.current_idx >= state.segments.size() && !state.finished) {
+		state.segments.clear();
+		state.current_idx = 0;
+		std::string error;
+		if (!state.live->Next(state.segments, bind_data.partials, error)) {
+			if (!error.empty()) {
+				throw InvalidInputException("Transcription failed: " + error);
+			}
+			state.finished = true;
+			TranscriptionStats::SetLastProfile(context, bind_data.config.model, state.live->Profile());
+			if (bind_data.config.verbose) {
+				Printer::Print(OutputStream::STREAM_STDERR, "Stopped");
+			}
+		}
+	}
+
+	idx_t output_idx = 0;
+	while (state.current_idx < state.segments.size() && output_idx < STANDARD_VECTOR_SIZE) {
+		const auto &live = state.segments[state.current_idx];
+
+		output.SetValue(0, output_idx, Value::INTEGER(live.segment.segment_id));
+		output.SetValue(1, output_idx, Value::DOUBLE(live.segment.start_time));
+		output.SetValue(2, output_idx, Value::DOUBLE(live.segment.end_time));
+		output.SetValue(3, output_idx, Value(live.segment.text));
+		output.SetValue(4, output_idx, Value::DOUBLE(live.segment.confidence));
+		output.SetValue(5, output_idx, Value::BOOLEAN(live.is_final));
+
+		state.current_idx++;
+		output_idx++;
+	}
+
+	output.SetCardinality(output_idx);
+}
+
 // ============================================================================
 // Registration
 // ============================================================================
@@ -450,6 +571,22 @@ void RegisterRecordFunctions(ExtensionLoader &loader) {
 	    ScalarFunction({LogicalType::INTEGER, LogicalType::INTEGER}, LogicalType::VARCHAR, WhisperMicLevelFunction));
 
 	loader.RegisterFunction(mic_level_set);
+
+	// whisper_record_stream(max_seconds DOUBLE, [model VARCHAR]) -> TABLE
+	// Named parameters: device_id, step, silence, partials
+	TableFunctionSet record_stream_set("whisper_record_stream");
+
+	TableFunction record_stream({LogicalType::DOUBLE}, RecordStreamExecute, RecordStreamBind, RecordStreamInit);
+	record_stream.named_parameters["device_id"] = LogicalType::INTEGER;
+	record_stream.named_parameters["step"] = LogicalType::DOUBLE;
+	record_stream.named_parameters["silence"] = LogicalType::DOUBLE;
+	record_stream.named_parameters["partials"] = LogicalType::BOOLEAN;
+	record_stream_set.AddFunction(record_stream);
+
+	record_stream.arguments = {LogicalType::DOUBLE, LogicalType::VARCHAR};
+	record_stream_set.AddFunction(record_stream);
+
+	loader.RegisterFunction(record_stream_set);
 }
 
 } // namespace duckdb
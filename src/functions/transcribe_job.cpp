@@ -0,0 +1,319 @@
+#include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/keyword_helper.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/main/appender.hpp"
+#include "duckdb/main/connection.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+
+#include "transcription_engine.hpp"
+#include "transcription_stats.hpp"
+#include "whisper_config.hpp"
+
+#include <unordered_set>
+
+namespace duckdb {
+
+// Defined in transcribe_table.cpp
+void AddInputPaths(ClientContext &context, const std::string &path, std::vector<std::string> &file_paths);
+void ReadRemoteFile(ClientContext &context, const std::string &file_path, std::vector<uint8_t> &buffer);
+
+// Files transcribed and committed together; an interrupted job loses at most one batch
+static constexpr idx_t DEFAULT_JOB_BATCH_SIZE = 64;
+
+// ============================================================================
+// whisper_transcribe_job(source, target_table, [model]) - Resumable bulk transcription
+// ============================================================================
+
+struct TranscribeJobBindData : public TableFunctionData {
+	std::vector<std::string> file_paths; // Expanded source list (globs and lists)
+	QualifiedName target;                // Table receiving one row per segment
+	QualifiedName progress;              // Table recording every finished file
+	std::string model_override;
+	idx_t batch_size = DEFAULT_JOB_BATCH_SIZE;
+	bool retry_errors = false; // Transcribe files that failed in an earlier run again
+};
+
+struct TranscribeJobState : public GlobalTableFunctionState {
+	bool finished = false;
+
+	idx_t MaxThreads() const override {
+		return 1; // Each batch is transcribed in parallel by TranscriptionEngine::TranscribeBatch
+	}
+};
+
+static QualifiedName ParseTableName(const std::string &name) {
+	auto qualified = QualifiedName::Parse(name);
+	if (qualified.schema.empty()) {
+		qualified.schema = DEFAULT_SCHEMA;
+	}
+	return qualified;
+}
+
+static std::string TableSql(const QualifiedName &table) {
+	std::string sql;
+	if (!table.catalog.empty()) {
+		sql += KeywordHelper::WriteOptionallyQuoted(table.catalog) + ".";
+	}
+	return sql + KeywordHelper::WriteOptionallyQuoted(table.schema) + "." +
+	       KeywordHelper::WriteOptionallyQuoted(table.name);
+}
+
+static unique_ptr<QueryResult> RunJobQuery(Connection &con, const std::string &sql) {
+	auto result = con.Query(sql);
+	if (result->HasError()) {
+		throw InvalidInputException("whisper_transcribe_job: " + result->GetError());
+	}
+	return std::move(result);
+}
+
+static unique_ptr<FunctionData> TranscribeJobBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+	auto bind_data = make_uniq<TranscribeJobBindData>();
+
+	if (input.inputs[0].type().id() == LogicalTypeId::LIST) {
+		for (auto &path : ListValue::GetChildren(input.inputs[0])) {
+			if (!path.IsNull()) {
+				AddInputPaths(context, path.GetValue<string>(), bind_data->file_paths);
+			}
+		}
+	} else {
+		AddInputPaths(context, input.inputs[0].GetValue<string>(), bind_data->file_paths);
+	}
+
+	if (input.inputs[1].IsNull()) {
+		throw InvalidInputException("whisper_transcribe_job: target_table must not be NULL");
+	}
+	bind_data->target = ParseTableName(input.inputs[1].GetValue<string>());
+	bind_data->progress = bind_data->target;
+	bind_data->progress.name += "_progress";
+
+	if (input.inputs.size() > 2 && !input.inputs[2].IsNull()) {
+		bind_data->model_override = input.inputs[2].GetValue<string>();
+	}
+
+	// Named parameters
+	for (auto &entry : input.named_parameters) {
+		if (entry.second.IsNull()) {
+			continue;
+		}
+		if (entry.first == "batch_size") {
+			auto batch_size = entry.second.GetValue<int32_t>();
+			if (batch_size < 1) {
+				throw InvalidInputException("whisper_transcribe_job: batch_size must be at least 1");
+			}
+			bind_data->batch_size = static_cast<idx_t>(batch_size);
+		} else if (entry.first == "progress_table") {
+			bind_data->progress = ParseTableName(StringValue::Get(entry.second));
+		} else if (entry.first == "retry_errors") {
+			bind_data->retry_errors = BooleanValue::Get(entry.second);
+		}
+	}
+
+	return_types.push_back(LogicalType::BIGINT); // files_total
+	names.push_back("files_total");
+
+	return_types.push_back(LogicalType::BIGINT); // files_skipped (finished by an earlier run)
+	names.push_back("files_skipped");
+
+	return_types.push_back(LogicalType::BIGINT); // files_transcribed
+	names.push_back("files_transcribed");
+
+	return_types.push_back(LogicalType::BIGINT); // files_failed
+	names.push_back("files_failed");
+
+	return_types.push_back(LogicalType::BIGINT); // segments
+	names.push_back("segments");
+
+	return std::move(bind_data);
+}
+
+static unique_ptr<GlobalTableFunctionState> TranscribeJobInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<TranscribeJobState>();
+}
+
+// Transcribe one batch of files; remote files are read through DuckDB's file system first
+static std::vector<TranscriptionResult> TranscribeJobBatch(ClientContext &context,
+                                                           const std::vector<std::string> &file_paths,
+                                                           const WhisperConfig &config) {
+	std::vector<TranscriptionInput> inputs(file_paths.size());
+	std::vector<std::vector<uint8_t>> buffers(file_paths.size());
+	std::vector<TranscriptionResult> read_errors(file_paths.size());
+	for (idx_t i = 0; i < file_paths.size(); i++) {
+		if (!FileSystem::IsRemoteFile(file_paths[i])) {
+			inputs[i].file_path = file_paths[i];
+			continue;
+		}
+		try {
+			ReadRemoteFile(context, file_paths[i], buffers[i]);
+		} catch (std::exception &ex) {
+			ErrorData error(ex);
+			read_errors[i].error = error.RawMessage();
+		}
+		inputs[i].is_blob = true;
+		inputs[i].data = buffers[i].data();
+		inputs[i].size = buffers[i].size();
+	}
+
+	auto results = TranscriptionEngine::TranscribeBatch(inputs, config);
+	for (idx_t i = 0; i < results.size(); i++) {
+		if (!read_errors[i].error.empty()) {
+			results[i].success = false;
+			results[i].error = "Failed to read file: " + read_errors[i].error;
+		}
+	}
+	return results;
+}
+
+static void TranscribeJobExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<TranscribeJobBindData>();
+	auto &state = data.global_state->Cast<TranscribeJobState>();
+	if (state.finished) {
+		output.SetCardinality(0);
+		return;
+	}
+
+	auto config = WhisperConfigManager::GetConfig(context);
+	if (!bind_data.model_override.empty()) {
+		config.model = bind_data.model_override;
+	}
+
+	// Results are written through a separate connection so every batch commits on its own
+	Connection con(*context.db);
+	auto target_sql = TableSql(bind_data.target);
+	auto progress_sql = TableSql(bind_data.progress);
+	RunJobQuery(con, "CREATE TABLE IF NOT EXISTS " + target_sql +
+	                     " (file_path VARCHAR, segment_id INTEGER, start_time DOUBLE, end_time DOUBLE, text VARCHAR, "
+	                     "confidence DOUBLE, language VARCHAR)");
+	RunJobQuery(con, "CREATE TABLE IF NOT EXISTS " + progress_sql +
+	                     " (file_path VARCHAR PRIMARY KEY, status VARCHAR, error VARCHAR, segments INTEGER, "
+	                     "finished_at TIMESTAMP)");
+	if (bind_data.retry_errors) {
+		RunJobQuery(con, "DELETE FROM " + progress_sql + " WHERE status = 'error'");
+	}
+
+	// Files recorded in the progress table were finished (or failed) by an earlier run
+	std::unordered_set<std::string> finished;
+	auto finished_result = RunJobQuery(con, "SELECT file_path FROM " + progress_sql);
+	while (auto chunk = finished_result->Fetch()) {
+		if (chunk->size() == 0) {
+			break;
+		}
+		chunk->data[0].Flatten(chunk->size());
+		auto paths = FlatVector::GetData<string_t>(chunk->data[0]);
+		for (idx_t i = 0; i < chunk->size(); i++) {
+			finished.insert(paths[i].GetString());
+		}
+	}
+
+	// A file listed twice (e.g. matched by two globs) is transcribed once; inserting it into the progress table twice
+	// would violate its primary key and roll back the whole batch on every run
+	std::vector<std::string> pending;
+	for (auto &file_path : bind_data.file_paths) {
+		if (finished.insert(file_path).second) {
+			pending.push_back(file_path);
+		}
+	}
+	int64_t files_skipped = static_cast<int64_t>(bind_data.file_paths.size() - pending.size());
+	int64_t files_transcribed = 0;
+	int64_t files_failed = 0;
+	int64_t n_segments = 0;
+
+	for (idx_t begin = 0; begin < pending.size(); begin += bind_data.batch_size) {
+		// Stopping between batches keeps everything committed so far; the next run resumes from here
+		if (context.interrupted) {
+			throw InterruptException();
+		}
+
+		// A model that cannot load fails the job instead of marking every remaining file as an error
+		std::string config_error;
+		if (!TranscriptionEngine::CheckConfig(config, config_error)) {
+			throw InvalidInputException("whisper_transcribe_job: " + config_error);
+		}
+
+		idx_t end = MinValue<idx_t>(begin + bind_data.batch_size, pending.size());
+		std::vector<std::string> batch(pending.begin() + begin, pending.begin() + end);
+		auto results = TranscribeJobBatch(context, batch, config);
+		TranscriptionStats::SetLastProfile(context, config.model, results.back().profile);
+
+		// Segments and progress of a batch commit together, so a file is never recorded half-written
+		auto finished_at = Value::TIMESTAMP(Timestamp::GetCurrentTimestamp());
+		con.BeginTransaction();
+		try {
+			Appender segments(con, bind_data.target.catalog, bind_data.target.schema, bind_data.target.name);
+			Appender progress(con, bind_data.progress.catalog, bind_data.progress.schema, bind_data.progress.name);
+			for (idx_t i = 0; i < batch.size(); i++) {
+				auto &result = results[i];
+				if (result.success) {
+					for (auto &segment : result.segments) {
+						segments.BeginRow();
+						segments.Append(batch[i].c_str());
+						segments.Append<int32_t>(segment.segment_id);
+						segments.Append<double>(segment.start_time);
+						segments.Append<double>(segment.end_time);
+						segments.Append(segment.text.c_str());
+						segments.Append<double>(segment.confidence);
+						segments.Append(segment.language.c_str());
+						segments.EndRow();
+					}
+				}
+
+				progress.BeginRow();
+				progress.Append(batch[i].c_str());
+				progress.Append(result.success ? "done" : "error");
+				progress.Append(result.success ? Value(LogicalType::VARCHAR) : Value(result.error));
+				progress.Append<int32_t>(static_cast<int32_t>(result.segments.size()));
+				progress.Append(finished_at);
+				progress.EndRow();
+
+				if (result.success) {
+					files_transcribed++;
+					n_segments += static_cast<int64_t>(result.segments.size());
+				} else {
+					files_failed++;
+				}
+			}
+			segments.Close();
+			progress.Close();
+			con.Commit();
+		} catch (...) {
+			if (con.HasActiveTransaction()) {
+				con.Rollback();
+			}
+			throw;
+		}
+	}
+
+	output.SetValue(0, 0, Value::BIGINT(static_cast<int64_t>(bind_data.file_paths.size())));
+	output.SetValue(1, 0, Value::BIGINT(files_skipped));
+	output.SetValue(2, 0, Value::BIGINT(files_transcribed));
+	output.SetValue(3, 0, Value::BIGINT(files_failed));
+	output.SetValue(4, 0, Value::BIGINT(n_segments));
+	output.SetCardinality(1);
+	state.finished = true;
+}
+
+static void AddTranscribeJobFunction(TableFunctionSet &set, vector<LogicalType> arguments) {
+	TableFunction function(std::move(arguments), TranscribeJobExecute, TranscribeJobBind, TranscribeJobInit);
+	function.named_parameters["batch_size"] = LogicalType::INTEGER;
+	function.named_parameters["progress_table"] = LogicalType::VARCHAR;
+	function.named_parameters["retry_errors"] = LogicalType::BOOLEAN;
+	set.AddFunction(function);
+}
+
+void RegisterTranscribeJobFunction(ExtensionLoader &loader) {
+	// whisper_transcribe_job(source VARCHAR | VARCHAR[], target_table VARCHAR, model? VARCHAR) -> TABLE
+	// Transcribes every source file into target_table batch by batch, skipping files finished by earlier runs
+	TableFunctionSet job_set("whisper_transcribe_job");
+	vector<LogicalType> source_types = {LogicalType::VARCHAR, LogicalType::LIST(LogicalType::VARCHAR)};
+	for (auto &source_type : source_types) {
+		AddTranscribeJobFunction(job_set, {source_type, LogicalType::VARCHAR});
+		AddTranscribeJobFunction(job_set, {source_type, LogicalType::VARCHAR, LogicalType::VARCHAR});
+	}
+	loader.RegisterFunction(job_set);
+}
+
+} // namespace duckdb
@@ -4,142 +4,238 @@
 #include "duckdb/common/exception.hpp"
 
 #include "transcription_engine.hpp"
+#include "transcription_stats.hpp"
 #include "whisper_config.hpp"
 
 namespace duckdb {
 
-static void WhisperTranscribeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+// Transcribe a whole input vector as one batch so rows are decoded and inferred in parallel
+static void TranscribeVector(DataChunk &args, ExpressionState &state, Vector &result, bool is_blob, bool translate) {
 	auto &context = state.GetContext();
 	auto config = WhisperConfigManager::GetConfig(context);
+	config.translate = translate;
 
-	auto &input = args.data[0];
-	idx_t count = args.size();
+	bool all_constant = args.AllConstant();
+	idx_t count = all_constant ? 1 : args.size();
 
 	// Check if optional model parameter is provided
 	bool has_model_param = args.ColumnCount() > 1;
 
-	UnaryExecutor::Execute<string_t, string_t>(input, result, count, [&](string_t input_val) {
-		// Override model if parameter provided
-		WhisperConfig local_config = config;
-		if (has_model_param) {
-			auto &model_vec = args.data[1];
-			if (model_vec.GetType().id() == LogicalTypeId::VARCHAR) {
-				auto model_val = FlatVector::GetData<string_t>(model_vec)[0];
-				local_config.model = model_val.GetString();
-			}
+	UnifiedVectorFormat input_format;
+	args.data[0].ToUnifiedFormat(count, input_format);
+	auto input_data = UnifiedVectorFormat::GetData<string_t>(input_format);
+
+	UnifiedVectorFormat model_format;
+	const string_t *model_data = nullptr;
+	if (has_model_param) {
+		args.data[1].ToUnifiedFormat(count, model_format);
+		model_data = UnifiedVectorFormat::GetData<string_t>(model_format);
+	}
+
+	// Collect non-NULL rows into a batch
+	std::vector<TranscriptionInput> inputs;
+	std::vector<idx_t> input_rows;
+	inputs.reserve(count);
+	input_rows.reserve(count);
+
+	for (idx_t row = 0; row < count; row++) {
+		auto input_idx = input_format.sel->get_index(row);
+		if (!input_format.validity.RowIsValid(input_idx)) {
+			continue;
 		}
 
-		// Check if input is a file path (VARCHAR) or BLOB
-		TranscriptionResult transcription;
-
-		std::string input_str = input_val.GetString();
-
-		// Try to transcribe as file path
-		transcription = TranscriptionEngine::TranscribeFile(input_str, local_config);
-
-		if (!transcription.success) {
-			throw InvalidInputException("Transcription failed: " + transcription.error);
+		TranscriptionInput input;
+		const auto &input_val = input_data[input_idx];
+		if (is_blob) {
+			input.is_blob = true;
+			input.data = reinterpret_cast<const uint8_t *>(input_val.GetData());
+			input.size = input_val.GetSize();
+		} else {
+			input.file_path = input_val.GetString();
 		}
 
-		return StringVector::AddString(result, transcription.full_text);
-	});
-}
-
-static void WhisperTranscribeBlobFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &context = state.GetContext();
-	auto config = WhisperConfigManager::GetConfig(context);
-
-	auto &input = args.data[0];
-	idx_t count = args.size();
-
-	// Check if optional model parameter is provided
-	bool has_model_param = args.ColumnCount() > 1;
-
-	UnaryExecutor::Execute<string_t, string_t>(input, result, count, [&](string_t blob_val) {
 		// Override model if parameter provided
-		WhisperConfig local_config = config;
 		if (has_model_param) {
-			auto &model_vec = args.data[1];
-			if (model_vec.GetType().id() == LogicalTypeId::VARCHAR) {
-				auto model_val = FlatVector::GetData<string_t>(model_vec)[0];
-				local_config.model = model_val.GetString();
+			auto model_idx = model_format.sel->get_index(row);
+			if (model_format.validity.RowIsValid(model_idx)) {
+				input.model = model_data[model_idx].GetString();
 			}
 		}
 
-		// Transcribe from BLOB
-		TranscriptionResult transcription = TranscriptionEngine::TranscribeMemory(
-		    reinterpret_cast<const uint8_t *>(blob_val.GetData()), blob_val.GetSize(), local_config);
+		inputs.push_back(std::move(input));
+		input_rows.push_back(row);
+	}
 
-		if (!transcription.success) {
-			throw InvalidInputException("Transcription failed: " + transcription.error);
+	auto transcriptions = TranscriptionEngine::TranscribeBatch(inputs, config, true);
+
+	// Report the first failing row, matching row-at-a-time execution (rows never started have no error)
+	for (auto &transcription : transcriptions) {
+		if (!transcription.success && !transcription.error.empty()) {
+			throw InvalidInputException((translate ? "Translation failed: " : "Transcription failed: ") +
+			                            transcription.error);
+		}
+	}
+	if (!transcriptions.empty()) {
+		// The last row of the chunk stands for it in whisper_last_profile()
+		auto &last_model = inputs.back().model.empty() ? config.model : inputs.back().model;
+		TranscriptionStats::SetLastProfile(context, last_model, transcriptions.back().profile);
+	}
+
+	if (all_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		if (transcriptions.empty()) {
+			ConstantVector::SetNull(result, true);
+			return;
+		}
+		ConstantVector::GetData<string_t>(result)[0] = StringVector::AddString(result, transcriptions[0].full_text);
+		return;
+	}
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<string_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+
+	idx_t next = 0;
+	for (idx_t row = 0; row < count; row++) {
+		if (next < input_rows.size() && input_rows[next] == row) {
+			result_data[row] = StringVector::AddString(result, transcriptions[next].full_text);
+			next++;
+		} else {
+			result_validity.SetInvalid(row);
 		}
+	}
+}
+
+static void WhisperTranscribeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	TranscribeVector(args, state, result, false, false);
+}
 
-		return StringVector::AddString(result, transcription.full_text);
-	});
+static void WhisperTranscribeBlobFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	TranscribeVector(args, state, result, true, false);
 }
 
 // whisper_translate - translates audio to English
 static void WhisperTranslateFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &context = state.GetContext();
-	auto config = WhisperConfigManager::GetConfig(context);
-	config.translate = true; // Enable translation to English
-
-	auto &input = args.data[0];
-	idx_t count = args.size();
-
-	// Check if optional model parameter is provided
-	bool has_model_param = args.ColumnCount() > 1;
-
-	UnaryExecutor::Execute<string_t, string_t>(input, result, count, [&](string_t input_val) {
-		WhisperConfig local_config = config;
-		if (has_model_param) {
-			auto &model_vec = args.data[1];
-			if (model_vec.GetType().id() == LogicalTypeId::VARCHAR) {
-				auto model_val = FlatVector::GetData<string_t>(model_vec)[0];
-				local_config.model = model_val.GetString();
-			}
-		}
+	TranscribeVector(args, state, result, false, true);
+}
 
-		std::string input_str = input_val.GetString();
-		TranscriptionResult transcription = TranscriptionEngine::TranscribeFile(input_str, local_config);
+static void WhisperTranslateBlobFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	TranscribeVector(args, state, result, true, true);
+}
 
-		if (!transcription.success) {
-			throw InvalidInputException("Translation failed: " + transcription.error);
-		}
+// Audio read by whisper_detect_language when no length is given (whisper's 30s window)
+static constexpr double DEFAULT_DETECT_SECONDS = 30.0;
 
-		return StringVector::AddString(result, transcription.full_text);
-	});
+static LogicalType LanguageDetectionType() {
+	child_list_t<LogicalType> children;
+	children.push_back(make_pair("language", LogicalType::VARCHAR));
+	children.push_back(make_pair("probability", LogicalType::DOUBLE));
+	return LogicalType::STRUCT(std::move(children));
 }
 
-static void WhisperTranslateBlobFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+// whisper_detect_language - language of the first seconds of audio, without transcribing it
+static void DetectLanguageVector(DataChunk &args, ExpressionState &state, Vector &result, bool is_blob) {
 	auto &context = state.GetContext();
 	auto config = WhisperConfigManager::GetConfig(context);
-	config.translate = true; // Enable translation to English
 
-	auto &input = args.data[0];
-	idx_t count = args.size();
+	bool all_constant = args.AllConstant();
+	idx_t count = all_constant ? 1 : args.size();
+
+	UnifiedVectorFormat input_format;
+	args.data[0].ToUnifiedFormat(count, input_format);
+	auto input_data = UnifiedVectorFormat::GetData<string_t>(input_format);
+
+	UnifiedVectorFormat model_format;
+	const string_t *model_data = nullptr;
+	if (args.ColumnCount() > 1) {
+		args.data[1].ToUnifiedFormat(count, model_format);
+		model_data = UnifiedVectorFormat::GetData<string_t>(model_format);
+	}
+
+	double seconds = DEFAULT_DETECT_SECONDS;
+	if (args.ColumnCount() > 2) {
+		// The detection window applies to the whole batch, so it must be a constant
+		if (args.data[2].GetVectorType() != VectorType::CONSTANT_VECTOR || ConstantVector::IsNull(args.data[2])) {
+			throw InvalidInputException("whisper_detect_language: seconds must be a constant");
+		}
+		seconds = ConstantVector::GetData<double>(args.data[2])[0];
+		if (seconds <= 0) {
+			throw InvalidInputException("whisper_detect_language: seconds must be positive");
+		}
+	}
+
+	// Collect non-NULL rows into a batch
+	std::vector<TranscriptionInput> inputs;
+	std::vector<idx_t> input_rows;
+	inputs.reserve(count);
+	input_rows.reserve(count);
+
+	for (idx_t row = 0; row < count; row++) {
+		auto input_idx = input_format.sel->get_index(row);
+		if (!input_format.validity.RowIsValid(input_idx)) {
+			continue;
+		}
 
-	bool has_model_param = args.ColumnCount() > 1;
+		TranscriptionInput input;
+		const auto &input_val = input_data[input_idx];
+		if (is_blob) {
+			input.is_blob = true;
+			input.data = reinterpret_cast<const uint8_t *>(input_val.GetData());
+			input.size = input_val.GetSize();
+		} else {
+			input.file_path = input_val.GetString();
+		}
 
-	UnaryExecutor::Execute<string_t, string_t>(input, result, count, [&](string_t blob_val) {
-		WhisperConfig local_config = config;
-		if (has_model_param) {
-			auto &model_vec = args.data[1];
-			if (model_vec.GetType().id() == LogicalTypeId::VARCHAR) {
-				auto model_val = FlatVector::GetData<string_t>(model_vec)[0];
-				local_config.model = model_val.GetString();
+		if (model_data) {
+			auto model_idx = model_format.sel->get_index(row);
+			if (model_format.validity.RowIsValid(model_idx)) {
+				input.model = model_data[model_idx].GetString();
 			}
 		}
 
-		TranscriptionResult transcription = TranscriptionEngine::TranscribeMemory(
-		    reinterpret_cast<const uint8_t *>(blob_val.GetData()), blob_val.GetSize(), local_config);
+		inputs.push_back(std::move(input));
+		input_rows.push_back(row);
+	}
 
-		if (!transcription.success) {
-			throw InvalidInputException("Translation failed: " + transcription.error);
+	auto detections = TranscriptionEngine::DetectLanguageBatch(inputs, seconds, config);
+	for (auto &detection : detections) {
+		if (!detection.success) {
+			throw InvalidInputException("Language detection failed: " + detection.error);
 		}
+	}
+
+	auto &entries = StructVector::GetEntries(result);
+	auto &language_vector = *entries[0];
+	auto &probability_vector = *entries[1];
+	auto language_data = FlatVector::GetData<string_t>(language_vector);
+	auto probability_data = FlatVector::GetData<double>(probability_vector);
+	auto &result_validity = FlatVector::Validity(result);
+
+	idx_t next = 0;
+	for (idx_t row = 0; row < count; row++) {
+		if (next < input_rows.size() && input_rows[next] == row) {
+			language_data[row] = StringVector::AddString(language_vector, detections[next].language);
+			probability_data[row] = detections[next].probability;
+			next++;
+		} else {
+			// A NULL struct has NULL fields as well
+			result_validity.SetInvalid(row);
+			FlatVector::SetNull(language_vector, row, true);
+			FlatVector::SetNull(probability_vector, row, true);
+		}
+	}
+
+	if (all_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
 
-		return StringVector::AddString(result, transcription.full_text);
-	});
+static void WhisperDetectLanguageFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	DetectLanguageVector(args, state, result, false);
+}
+
+static void WhisperDetectLanguageBlobFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	DetectLanguageVector(args, state, result, true);
 }
 
 void RegisterTranscribeScalarFunctions(ExtensionLoader &loader) {
@@ -182,6 +278,23 @@ void RegisterTranscribeScalarFunctions(ExtensionLoader &loader) {
 	    ScalarFunction({LogicalType::BLOB, LogicalType::VARCHAR}, LogicalType::VARCHAR, WhisperTranslateBlobFunction));
 
 	loader.RegisterFunction(translate_set);
+
+	// whisper_detect_language(audio VARCHAR | BLOB, [model VARCHAR], [seconds DOUBLE])
+	//   -> STRUCT(language VARCHAR, probability DOUBLE)
+	// Runs only the encoder and language scoring, for routing inputs to per-language models
+	ScalarFunctionSet detect_set("whisper_detect_language");
+	auto detection_type = LanguageDetectionType();
+	vector<pair<LogicalType, scalar_function_t>> detect_inputs = {
+	    {LogicalType::VARCHAR, WhisperDetectLanguageFunction}, {LogicalType::BLOB, WhisperDetectLanguageBlobFunction}};
+	for (auto &detect_input : detect_inputs) {
+		detect_set.AddFunction(ScalarFunction({detect_input.first}, detection_type, detect_input.second));
+		detect_set.AddFunction(
+		    ScalarFunction({detect_input.first, LogicalType::VARCHAR}, detection_type, detect_input.second));
+		detect_set.AddFunction(ScalarFunction({detect_input.first, LogicalType::VARCHAR, LogicalType::DOUBLE},
+		                                      detection_type, detect_input.second));
+	}
+
+	loader.RegisterFunction(detect_set);
 }
 
 } // namespace duckdb
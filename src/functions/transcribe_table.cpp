@@ -2,47 +2,134 @@
 #include "duckdb/function/table_function.hpp"
 
 #include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/file_system.hpp"
 #include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+#include "duckdb/planner/expression/bound_between_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
 
 #include "transcription_engine.hpp"
+#include "transcription_stats.hpp"
 #include "whisper_config.hpp"
+#include "whisper_context.hpp"
+
+#include <atomic>
 
 namespace duckdb {
 
 struct TranscribeSegmentsBindData : public TableFunctionData {
-	std::string file_path;
-	std::vector<uint8_t> blob_data;
+	std::vector<std::string> file_paths; // Expanded file list (globs and lists)
+	Value blob_value;                    // BLOB argument, referenced in place rather than copied
 	bool is_blob;
 	std::string model_override;
 	std::string language_override;
-	bool translate; // Translate to English instead of transcribe
+	std::string format_override;          // Container format hint (format := 'wav')
+	bool translate;                       // Translate to English instead of transcribe
+	named_parameter_map_t decoder_params; // Per-call decoder tuning (beam_size := 5, ...)
+	bool token_granularity = false;       // whisper_transcribe_words: one row per token instead of per word
+	double range_start = 0.0;             // Decoded time window, narrowed by start_time / end_time filters
+	double range_end = -1.0;              // (< 0 = to the end)
+};
+
+// A row of whisper_transcribe_words: a word (or token) with its timing and probability
+struct TranscriptionWord {
+	int segment_id;
+	std::string text;
+	double start_time;
+	double end_time;
+	double probability; // Mean of the word's token probabilities
 };
 
 struct TranscribeSegmentsState : public GlobalTableFunctionState {
-	TranscriptionResult result;
-	idx_t current_segment;
-	bool initialized;
+	WhisperConfig config;         // Resolved once per query
+	std::atomic<idx_t> next_file; // Next input to hand out to a thread
+	idx_t max_threads;
+	vector<column_t> column_ids; // Projected columns (functions with projection pushdown)
 
-	TranscribeSegmentsState() : current_segment(0), initialized(false) {
+	TranscribeSegmentsState() : next_file(0), max_threads(1) {
 	}
 
 	idx_t MaxThreads() const override {
-		return 1; // Single-threaded for now
+		return max_threads;
 	}
 };
 
-static unique_ptr<FunctionData> TranscribeSegmentsBind(ClientContext &context, TableFunctionBindInput &input,
-                                                       vector<LogicalType> &return_types, vector<string> &names) {
-	auto bind_data = make_uniq<TranscribeSegmentsBindData>();
+struct TranscribeSegmentsLocalState : public LocalTableFunctionState {
+	std::vector<TranscriptionSegment> segments;
+	idx_t file_idx;
+	idx_t current_segment;
+
+	// Streaming mode: the current file is decoded and transcribed one window at a time
+	unique_ptr<StreamingTranscriber> stream;
+	std::vector<uint8_t> remote_buffer; // Backing memory for remote files
 
+	// whisper_transcribe_words: the words of the current segments and the next word_id of the file
+	std::vector<TranscriptionWord> words;
+	idx_t current_word = 0;
+	int next_word_id = 0;
+
+	TranscribeSegmentsLocalState() : file_idx(0), current_segment(0) {
+	}
+};
+
+// Named parameters that override the decoder tuning settings of the same name (whisper_<name>)
+static const char *const DECODER_PARAMETERS[] = {"beam_size",     "best_of",    "temperature", "temperature_inc",
+                                                 "entropy_thold", "no_context", "audio_ctx"};
+
+static void ApplyDecoderParameter(WhisperConfig &config, const std::string &name, const Value &value) {
+	if (name == "beam_size") {
+		config.beam_size = value.GetValue<int32_t>();
+	} else if (name == "best_of") {
+		config.best_of = value.GetValue<int32_t>();
+	} else if (name == "temperature") {
+		config.temperature = value.GetValue<double>();
+	} else if (name == "temperature_inc") {
+		config.temperature_inc = value.GetValue<double>();
+	} else if (name == "entropy_thold") {
+		config.entropy_thold = value.GetValue<double>();
+	} else if (name == "no_context") {
+		config.no_context = value.GetValue<bool>();
+	} else if (name == "audio_ctx") {
+		config.audio_ctx = value.GetValue<int32_t>();
+	}
+}
+
+// Expand a path or glob pattern into the list of matching files (also used by whisper_audio_info and
+// whisper_transcribe_job)
+void AddInputPaths(ClientContext &context, const std::string &path, std::vector<std::string> &file_paths) {
+	if (!FileSystem::HasGlob(path)) {
+		file_paths.push_back(path);
+		return;
+	}
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto files = fs.GlobFiles(path, context, FileGlobOptions::DISALLOW_EMPTY);
+	for (auto &file : files) {
+		file_paths.push_back(file.path);
+	}
+}
+
+// Parse the arguments shared by the transcription table functions
+static void BindTranscribeInputs(ClientContext &context, TableFunctionBindInput &input,
+                                 TranscribeSegmentsBindData *bind_data) {
 	// Get input argument
-	if (input.inputs[0].type().id() == LogicalTypeId::BLOB) {
+	auto &input_type = input.inputs[0].type();
+	if (input_type.id() == LogicalTypeId::BLOB) {
 		bind_data->is_blob = true;
-		auto blob = input.inputs[0].GetValue<string>();
-		bind_data->blob_data.assign(blob.begin(), blob.end());
+		bind_data->blob_value = input.inputs[0];
+	} else if (input_type.id() == LogicalTypeId::LIST) {
+		bind_data->is_blob = false;
+		for (auto &path : ListValue::GetChildren(input.inputs[0])) {
+			if (!path.IsNull()) {
+				AddInputPaths(context, path.GetValue<string>(), bind_data->file_paths);
+			}
+		}
 	} else {
 		bind_data->is_blob = false;
-		bind_data->file_path = input.inputs[0].GetValue<string>();
+		AddInputPaths(context, input.inputs[0].GetValue<string>(), bind_data->file_paths);
 	}
 
 	// Check for optional parameters
@@ -60,6 +147,33 @@ static unique_ptr<FunctionData> TranscribeSegmentsBind(ClientContext &context, T
 		bind_data->translate = input.inputs[3].GetValue<bool>();
 	}
 
+	// Named parameters
+	auto format_entry = input.named_parameters.find("format");
+	if (format_entry != input.named_parameters.end() && !format_entry->second.IsNull()) {
+		bind_data->format_override = StringValue::Get(format_entry->second);
+	}
+	for (auto &name : DECODER_PARAMETERS) {
+		auto entry = input.named_parameters.find(name);
+		if (entry != input.named_parameters.end() && !entry->second.IsNull()) {
+			bind_data->decoder_params[name] = entry->second;
+		}
+	}
+}
+
+// Columns of whisper_transcribe_segments, in bind order
+static constexpr column_t SEGMENTS_SEGMENT_ID = 0;
+static constexpr column_t SEGMENTS_START_TIME = 1;
+static constexpr column_t SEGMENTS_END_TIME = 2;
+static constexpr column_t SEGMENTS_TEXT = 3;
+static constexpr column_t SEGMENTS_CONFIDENCE = 4;
+static constexpr column_t SEGMENTS_LANGUAGE = 5;
+static constexpr column_t SEGMENTS_FILE_PATH = 6;
+
+static unique_ptr<FunctionData> TranscribeSegmentsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                       vector<LogicalType> &return_types, vector<string> &names) {
+	auto bind_data = make_uniq<TranscribeSegmentsBindData>();
+	BindTranscribeInputs(context, input, bind_data.get());
+
 	// Define output columns
 	return_types.push_back(LogicalType::INTEGER); // segment_id
 	names.push_back("segment_id");
@@ -79,107 +193,657 @@ static unique_ptr<FunctionData> TranscribeSegmentsBind(ClientContext &context, T
 	return_types.push_back(LogicalType::VARCHAR); // language
 	names.push_back("language");
 
+	return_types.push_back(LogicalType::VARCHAR); // file_path (NULL for BLOB input)
+	names.push_back("file_path");
+
 	return std::move(bind_data);
 }
 
+// Resolve the configuration and the thread count of a transcription table function
+static unique_ptr<TranscribeSegmentsState> InitTranscribeState(ClientContext &context,
+                                                               const TranscribeSegmentsBindData &bind_data) {
+	auto state = make_uniq<TranscribeSegmentsState>();
+
+	auto &config = state->config;
+	config = WhisperConfigManager::GetConfig(context);
+
+	// Apply overrides
+	if (!bind_data.model_override.empty()) {
+		config.model = bind_data.model_override;
+	}
+	if (!bind_data.language_override.empty()) {
+		config.language = bind_data.language_override;
+	}
+	if (!bind_data.format_override.empty()) {
+		config.input_format = bind_data.format_override;
+	}
+	config.translate = bind_data.translate;
+	config.range_start = bind_data.range_start;
+	config.range_end = bind_data.range_end;
+	for (auto &entry : bind_data.decoder_params) {
+		ApplyDecoderParameter(config, entry.first, entry.second);
+	}
+
+	// One thread per file, bounded by the decoder states available for the model (on each GPU it is spread across)
+	idx_t n_inputs = bind_data.is_blob ? 1 : bind_data.file_paths.size();
+	idx_t max_states = static_cast<idx_t>(MaxValue<int>(config.max_concurrent_states, 1)) *
+	                   WhisperContextManager::ScheduledDeviceCount(config.use_gpu, config.gpu_device);
+	state->max_threads = MaxValue<idx_t>(MinValue<idx_t>(n_inputs, max_states), 1);
+	config.concurrent_runs =
+	    static_cast<int>(MinValue<idx_t>(state->max_threads, MaxValue<idx_t>(config.scheduler_threads, 1)));
+
+	return state;
+}
+
 static unique_ptr<GlobalTableFunctionState> TranscribeSegmentsInit(ClientContext &context,
                                                                    TableFunctionInitInput &input) {
-	return make_uniq<TranscribeSegmentsState>();
+	auto state = InitTranscribeState(context, input.bind_data->Cast<TranscribeSegmentsBindData>());
+	state->column_ids = input.column_ids;
+
+	// Confidences need a pass over every token, so only compute them when the column is read
+	state->config.segment_confidence = false;
+	for (auto column_id : state->column_ids) {
+		if (column_id == SEGMENTS_CONFIDENCE) {
+			state->config.segment_confidence = true;
+		}
+	}
+	return std::move(state);
 }
 
-static void TranscribeSegmentsExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
-	auto &bind_data = data.bind_data->Cast<TranscribeSegmentsBindData>();
-	auto &state = data.global_state->Cast<TranscribeSegmentsState>();
+// Segments are cut at whisper's 30 second decode windows, so none is longer than that
+static constexpr double MAX_SEGMENT_SECONDS = 30.0;
+// Audio kept beyond a segment edge bound so whisper still hears the words around it
+static constexpr double RANGE_MARGIN_SECONDS = 5.0;
+
+// The time column (start_time or end_time) an expression refers to, or INVALID_INDEX
+static column_t TimeColumn(LogicalGet &get, const Expression &expr) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+		return DConstants::INVALID_INDEX;
+	}
+	auto &colref = expr.Cast<BoundColumnRefExpression>();
+	auto &column_ids = get.GetColumnIds();
+	if (colref.binding.table_index != get.table_index || colref.binding.column_index >= column_ids.size()) {
+		return DConstants::INVALID_INDEX;
+	}
+	auto column = column_ids[colref.binding.column_index].GetPrimaryIndex();
+	if (column != SEGMENTS_START_TIME && column != SEGMENTS_END_TIME) {
+		return DConstants::INVALID_INDEX;
+	}
+	return column;
+}
+
+static bool ConstantSeconds(const Expression &expr, double &seconds) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		return false;
+	}
+	auto &value = expr.Cast<BoundConstantExpression>().value;
+	Value seconds_value;
+	if (value.IsNull() || !value.DefaultTryCastAs(LogicalType::DOUBLE, seconds_value)) {
+		return false;
+	}
+	seconds = seconds_value.GetValue<double>();
+	return true;
+}
 
-	// Initialize on first call
-	if (!state.initialized) {
-		auto config = WhisperConfigManager::GetConfig(context);
+// Narrow the decoded window by "column >= seconds" (lower bound) or "column <= seconds"
+static void ApplyTimeBound(TranscribeSegmentsBindData &bind_data, column_t column, bool lower, double seconds) {
+	if (lower) {
+		// A segment ending after the bound may have started up to a whole segment before it
+		double margin = column == SEGMENTS_START_TIME ? RANGE_MARGIN_SECONDS : MAX_SEGMENT_SECONDS;
+		bind_data.range_start = MaxValue(bind_data.range_start, seconds - margin);
+	} else {
+		double margin = column == SEGMENTS_END_TIME ? RANGE_MARGIN_SECONDS : MAX_SEGMENT_SECONDS;
+		double end = MaxValue(seconds + margin, 0.0);
+		bind_data.range_end = bind_data.range_end < 0.0 ? end : MinValue(bind_data.range_end, end);
+	}
+}
 
-		// Apply overrides
-		if (!bind_data.model_override.empty()) {
-			config.model = bind_data.model_override;
+static void DeriveTimeRange(LogicalGet &get, TranscribeSegmentsBindData &bind_data, const Expression &filter) {
+	switch (filter.GetExpressionClass()) {
+	case ExpressionClass::BOUND_CONJUNCTION: {
+		if (filter.GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+			for (auto &child : filter.Cast<BoundConjunctionExpression>().children) {
+				DeriveTimeRange(get, bind_data, *child);
+			}
+		}
+		break;
+	}
+	case ExpressionClass::BOUND_BETWEEN: {
+		auto &between = filter.Cast<BoundBetweenExpression>();
+		auto column = TimeColumn(get, *between.input);
+		double seconds;
+		if (column == DConstants::INVALID_INDEX) {
+			break;
+		}
+		if (ConstantSeconds(*between.lower, seconds)) {
+			ApplyTimeBound(bind_data, column, true, seconds);
+		}
+		if (ConstantSeconds(*between.upper, seconds)) {
+			ApplyTimeBound(bind_data, column, false, seconds);
+		}
+		break;
+	}
+	case ExpressionClass::BOUND_COMPARISON: {
+		auto &comparison = filter.Cast<BoundComparisonExpression>();
+		auto type = comparison.GetExpressionType();
+		double seconds;
+		auto column = TimeColumn(get, *comparison.left);
+		if (column == DConstants::INVALID_INDEX || !ConstantSeconds(*comparison.right, seconds)) {
+			// constant <op> column
+			column = TimeColumn(get, *comparison.right);
+			if (column == DConstants::INVALID_INDEX || !ConstantSeconds(*comparison.left, seconds)) {
+				break;
+			}
+			type = FlipComparisonExpression(type);
+		}
+		if (type == ExpressionType::COMPARE_EQUAL || type == ExpressionType::COMPARE_GREATERTHAN ||
+		    type == ExpressionType::COMPARE_GREATERTHANOREQUALTO) {
+			ApplyTimeBound(bind_data, column, true, seconds);
 		}
-		if (!bind_data.language_override.empty()) {
-			config.language = bind_data.language_override;
+		if (type == ExpressionType::COMPARE_EQUAL || type == ExpressionType::COMPARE_LESSTHAN ||
+		    type == ExpressionType::COMPARE_LESSTHANOREQUALTO) {
+			ApplyTimeBound(bind_data, column, false, seconds);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+// Filters on start_time / end_time limit the audio that is decoded and transcribed: the reader seeks to the
+// window instead of decoding everything before it. The filters stay in place, as whisper places segment edges
+// slightly differently when given only part of the input.
+static void TranscribeSegmentsPushdownFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data_p,
+                                             vector<unique_ptr<Expression>> &filters) {
+	auto &bind_data = bind_data_p->Cast<TranscribeSegmentsBindData>();
+	for (auto &filter : filters) {
+		DeriveTimeRange(get, bind_data, *filter);
+	}
+}
+
+static unique_ptr<LocalTableFunctionState> TranscribeSegmentsInitLocal(ExecutionContext &context,
+                                                                       TableFunctionInitInput &input,
+                                                                       GlobalTableFunctionState *global_state) {
+	return make_uniq<TranscribeSegmentsLocalState>();
+}
+
+static const uint8_t *BlobData(const TranscribeSegmentsBindData &bind_data) {
+	return reinterpret_cast<const uint8_t *>(StringValue::Get(bind_data.blob_value).data());
+}
+
+static size_t BlobSize(const TranscribeSegmentsBindData &bind_data) {
+	return StringValue::Get(bind_data.blob_value).size();
+}
+
+// Read a remote file (e.g. s3://) through DuckDB's file system (also used by whisper_transcribe_job)
+void ReadRemoteFile(ClientContext &context, const std::string &file_path, std::vector<uint8_t> &buffer) {
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto handle = fs.OpenFile(file_path, FileFlags::FILE_FLAGS_READ);
+	auto file_size = handle->GetFileSize();
+	buffer.resize(file_size);
+	handle->Read(buffer.data(), file_size);
+}
+
+// Transcribe a file, reading remote paths through DuckDB's file system
+static TranscriptionResult TranscribeInputFile(ClientContext &context, const std::string &file_path,
+                                               const WhisperConfig &config) {
+	if (!FileSystem::IsRemoteFile(file_path)) {
+		return TranscriptionEngine::TranscribeFile(file_path, config);
+	}
+
+	std::vector<uint8_t> buffer;
+	ReadRemoteFile(context, file_path, buffer);
+	return TranscriptionEngine::TranscribeMemory(buffer.data(), buffer.size(), config);
+}
+
+// Open a streaming transcriber for an input
+static bool OpenInputStream(ClientContext &context, const TranscribeSegmentsBindData &bind_data, idx_t file_idx,
+                            const WhisperConfig &config, TranscribeSegmentsLocalState &local, std::string &error) {
+	local.stream = make_uniq<StreamingTranscriber>(config);
+	if (bind_data.is_blob) {
+		return local.stream->OpenMemory(BlobData(bind_data), BlobSize(bind_data), error);
+	}
+
+	auto &file_path = bind_data.file_paths[file_idx];
+	if (!FileSystem::IsRemoteFile(file_path)) {
+		return local.stream->OpenFile(file_path, error);
+	}
+	ReadRemoteFile(context, file_path, local.remote_buffer);
+	return local.stream->OpenMemory(local.remote_buffer.data(), local.remote_buffer.size(), error);
+}
+
+static void ThrowTranscriptionError(const TranscribeSegmentsBindData &bind_data, idx_t file_idx, idx_t n_inputs,
+                                    const std::string &error) {
+	if (bind_data.is_blob || n_inputs == 1) {
+		throw InvalidInputException("Transcription failed: " + error);
+	}
+	throw InvalidInputException("Transcription failed for '" + bind_data.file_paths[file_idx] + "': " + error);
+}
+
+// Replace local.segments with the next non-empty batch: the next file, or the next window of a streamed file
+// Returns false once every input has been handed out and transcribed.
+static bool LoadNextSegments(ClientContext &context, const TranscribeSegmentsBindData &bind_data,
+                             TranscribeSegmentsState &state, TranscribeSegmentsLocalState &local) {
+	idx_t n_inputs = bind_data.is_blob ? 1 : bind_data.file_paths.size();
+
+	local.segments.clear();
+	local.current_segment = 0;
+	while (local.segments.empty()) {
+		if (local.stream) {
+			std::string error;
+			if (local.stream->Next(local.segments, error)) {
+				TranscriptionStats::SetLastProfile(context, state.config.model, local.stream->Profile());
+				continue;
+			}
+			if (!error.empty()) {
+				ThrowTranscriptionError(bind_data, local.file_idx, n_inputs, error);
+			}
+			local.stream.reset();
+			local.remote_buffer = std::vector<uint8_t>();
+		}
+
+		idx_t file_idx = state.next_file.fetch_add(1);
+		if (file_idx >= n_inputs) {
+			return false;
+		}
+		local.file_idx = file_idx;
+		local.next_word_id = 0;
+
+		if (state.config.streaming) {
+			std::string error;
+			if (!OpenInputStream(context, bind_data, file_idx, state.config, local, error)) {
+				ThrowTranscriptionError(bind_data, file_idx, n_inputs, error);
+			}
+			continue;
 		}
-		config.translate = bind_data.translate;
 
 		// Perform transcription
+		TranscriptionResult result;
 		if (bind_data.is_blob) {
-			state.result =
-			    TranscriptionEngine::TranscribeMemory(bind_data.blob_data.data(), bind_data.blob_data.size(), config);
+			result = TranscriptionEngine::TranscribeMemory(BlobData(bind_data), BlobSize(bind_data), state.config);
 		} else {
-			state.result = TranscriptionEngine::TranscribeFile(bind_data.file_path, config);
+			result = TranscribeInputFile(context, bind_data.file_paths[file_idx], state.config);
 		}
 
-		if (!state.result.success) {
-			throw InvalidInputException("Transcription failed: " + state.result.error);
+		if (!result.success) {
+			ThrowTranscriptionError(bind_data, file_idx, n_inputs, result.error);
 		}
+		TranscriptionStats::SetLastProfile(context, state.config.model, result.profile);
+		local.segments = std::move(result.segments);
+	}
+	return true;
+}
 
-		state.initialized = true;
+// A chunk holds rows of a single file, so the path is constant
+static void SetFilePathVector(const TranscribeSegmentsBindData &bind_data, const TranscribeSegmentsLocalState &local,
+                              Vector &file_path_vector) {
+	file_path_vector.SetVectorType(VectorType::CONSTANT_VECTOR);
+	if (bind_data.is_blob) {
+		ConstantVector::SetNull(file_path_vector, true);
+	} else {
+		ConstantVector::GetData<string_t>(file_path_vector)[0] =
+		    StringVector::AddString(file_path_vector, bind_data.file_paths[local.file_idx]);
 	}
+}
 
-	// Output segments
-	idx_t output_idx = 0;
-	while (state.current_segment < state.result.segments.size() && output_idx < STANDARD_VECTOR_SIZE) {
-		const auto &segment = state.result.segments[state.current_segment];
+static void TranscribeSegmentsExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<TranscribeSegmentsBindData>();
+	auto &state = data.global_state->Cast<TranscribeSegmentsState>();
+	auto &local = data.local_state->Cast<TranscribeSegmentsLocalState>();
 
-		output.SetValue(0, output_idx, Value::INTEGER(segment.segment_id));
-		output.SetValue(1, output_idx, Value::DOUBLE(segment.start_time));
-		output.SetValue(2, output_idx, Value::DOUBLE(segment.end_time));
-		output.SetValue(3, output_idx, Value(segment.text));
-		output.SetValue(4, output_idx, Value::DOUBLE(segment.confidence));
-		output.SetValue(5, output_idx, Value(segment.language));
+	// Claim the next file (or the next window of a streamed file) once the current segments are exhausted
+	if (local.current_segment >= local.segments.size() && !LoadNextSegments(context, bind_data, state, local)) {
+		output.SetCardinality(0);
+		return;
+	}
 
-		state.current_segment++;
-		output_idx++;
+	// Output segments (a chunk never spans two files); only the projected columns are filled
+	idx_t count = MinValue<idx_t>(local.segments.size() - local.current_segment, STANDARD_VECTOR_SIZE);
+	const auto *segments = local.segments.data() + local.current_segment;
+
+	for (idx_t col = 0; col < state.column_ids.size(); col++) {
+		auto &vector = output.data[col];
+		switch (state.column_ids[col]) {
+		case SEGMENTS_SEGMENT_ID: {
+			auto segment_id_data = FlatVector::GetData<int32_t>(vector);
+			for (idx_t i = 0; i < count; i++) {
+				segment_id_data[i] = segments[i].segment_id;
+			}
+			break;
+		}
+		case SEGMENTS_START_TIME: {
+			auto start_time_data = FlatVector::GetData<double>(vector);
+			for (idx_t i = 0; i < count; i++) {
+				start_time_data[i] = segments[i].start_time;
+			}
+			break;
+		}
+		case SEGMENTS_END_TIME: {
+			auto end_time_data = FlatVector::GetData<double>(vector);
+			for (idx_t i = 0; i < count; i++) {
+				end_time_data[i] = segments[i].end_time;
+			}
+			break;
+		}
+		case SEGMENTS_TEXT: {
+			auto text_data = FlatVector::GetData<string_t>(vector);
+			for (idx_t i = 0; i < count; i++) {
+				text_data[i] = StringVector::AddString(vector, segments[i].text);
+			}
+			break;
+		}
+		case SEGMENTS_CONFIDENCE: {
+			auto confidence_data = FlatVector::GetData<double>(vector);
+			for (idx_t i = 0; i < count; i++) {
+				confidence_data[i] = segments[i].confidence;
+			}
+			break;
+		}
+		case SEGMENTS_LANGUAGE: {
+			bool same_language = true;
+			for (idx_t i = 1; i < count && same_language; i++) {
+				same_language = segments[i].language == segments[0].language;
+			}
+
+			// Language is almost always uniform within a chunk, so emit it once as a constant when possible
+			if (same_language && count > 0) {
+				vector.SetVectorType(VectorType::CONSTANT_VECTOR);
+				ConstantVector::GetData<string_t>(vector)[0] = StringVector::AddString(vector, segments[0].language);
+			} else {
+				auto language_data = FlatVector::GetData<string_t>(vector);
+				for (idx_t i = 0; i < count; i++) {
+					language_data[i] = StringVector::AddString(vector, segments[i].language);
+				}
+			}
+			break;
+		}
+		case SEGMENTS_FILE_PATH:
+			SetFilePathVector(bind_data, local, vector);
+			break;
+		default:
+			// Row id requested without any real column (e.g. count(*))
+			vector.SetVectorType(VectorType::CONSTANT_VECTOR);
+			ConstantVector::SetNull(vector, true);
+			break;
+		}
 	}
 
-	output.SetCardinality(output_idx);
+	local.current_segment += count;
+	output.SetCardinality(count);
 }
 
-void RegisterTranscribeTableFunctions(ExtensionLoader &loader) {
-	// whisper_transcribe_segments(file_path VARCHAR, model? VARCHAR, language? VARCHAR, translate? BOOLEAN) -> TABLE
-	TableFunctionSet transcribe_segments_set("whisper_transcribe_segments");
+// ============================================================================
+// whisper_transcribe_words
+// ============================================================================
+
+// Columns of whisper_transcribe_words, in bind order
+static constexpr column_t WORDS_SEGMENT_ID = 0;
+static constexpr column_t WORDS_WORD_ID = 1;
+static constexpr column_t WORDS_START_TIME = 2;
+static constexpr column_t WORDS_END_TIME = 3;
+static constexpr column_t WORDS_TEXT = 4;
+static constexpr column_t WORDS_PROBABILITY = 5;
+static constexpr column_t WORDS_FILE_PATH = 6;
+
+static unique_ptr<FunctionData> TranscribeWordsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                    vector<LogicalType> &return_types, vector<string> &names) {
+	auto bind_data = make_uniq<TranscribeSegmentsBindData>();
+	BindTranscribeInputs(context, input, bind_data.get());
+
+	auto granularity_entry = input.named_parameters.find("granularity");
+	if (granularity_entry != input.named_parameters.end() && !granularity_entry->second.IsNull()) {
+		auto granularity = StringUtil::Lower(StringValue::Get(granularity_entry->second));
+		if (granularity != "word" && granularity != "token") {
+			throw InvalidInputException("Invalid granularity '%s': expected 'word' or 'token'", granularity);
+		}
+		bind_data->token_granularity = granularity == "token";
+	}
+
+	return_types.push_back(LogicalType::INTEGER); // segment_id
+	names.push_back("segment_id");
+
+	return_types.push_back(LogicalType::INTEGER); // word_id (per input)
+	names.push_back("word_id");
+
+	return_types.push_back(LogicalType::DOUBLE); // start_time
+	names.push_back("start_time");
+
+	return_types.push_back(LogicalType::DOUBLE); // end_time
+	names.push_back("end_time");
+
+	return_types.push_back(LogicalType::VARCHAR); // text
+	names.push_back("text");
 
-	// Version with just file path
-	TableFunction tf1({LogicalType::VARCHAR}, TranscribeSegmentsExecute, TranscribeSegmentsBind,
-	                  TranscribeSegmentsInit);
-	transcribe_segments_set.AddFunction(tf1);
+	return_types.push_back(LogicalType::DOUBLE); // probability
+	names.push_back("probability");
 
-	// Version with file path and model
-	TableFunction tf2({LogicalType::VARCHAR, LogicalType::VARCHAR}, TranscribeSegmentsExecute, TranscribeSegmentsBind,
-	                  TranscribeSegmentsInit);
-	transcribe_segments_set.AddFunction(tf2);
+	return_types.push_back(LogicalType::VARCHAR); // file_path (NULL for BLOB input)
+	names.push_back("file_path");
 
-	// Version with file path, model, and language
-	TableFunction tf3({LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR}, TranscribeSegmentsExecute,
-	                  TranscribeSegmentsBind, TranscribeSegmentsInit);
-	transcribe_segments_set.AddFunction(tf3);
+	return std::move(bind_data);
+}
+
+static unique_ptr<GlobalTableFunctionState> TranscribeWordsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto state = InitTranscribeState(context, input.bind_data->Cast<TranscribeSegmentsBindData>());
+	state->column_ids = input.column_ids;
+
+	// Token timestamps cost an extra pass over each window, so only compute them when a time column is read
+	state->config.collect_tokens = true;
+	for (auto column_id : state->column_ids) {
+		if (column_id == WORDS_START_TIME || column_id == WORDS_END_TIME) {
+			state->config.token_timestamps = true;
+		}
+	}
+	return std::move(state);
+}
+
+// Length of text without a trailing, incomplete UTF-8 sequence (whisper's byte-level tokens can split characters)
+static size_t CompleteUtf8Length(const std::string &text) {
+	size_t lead = text.size();
+	while (lead > 0 && text.size() - lead < 3 && (static_cast<unsigned char>(text[lead - 1]) & 0xC0) == 0x80) {
+		lead--;
+	}
+	if (lead == 0) {
+		return text.size();
+	}
+	auto byte = static_cast<unsigned char>(text[lead - 1]);
+	size_t expected = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+	size_t present = text.size() - lead + 1;
+	return present < expected ? lead - 1 : text.size();
+}
+
+// Group the tokens of each segment into words (a token starting with a space opens a new word) or, at token
+// granularity, into tokens; either way no row ends inside a UTF-8 character
+static void SplitWords(const std::vector<TranscriptionSegment> &segments, bool by_token,
+                       std::vector<TranscriptionWord> &words) {
+	for (auto &segment : segments) {
+		TranscriptionWord word;
+		idx_t n_tokens = 0;
+		auto flush = [&]() {
+			if (n_tokens == 0) {
+				return;
+			}
+			word.text.resize(CompleteUtf8Length(word.text));
+			StringUtil::Trim(word.text);
+			word.probability /= static_cast<double>(n_tokens);
+			if (!word.text.empty()) {
+				words.push_back(std::move(word));
+			}
+			word = TranscriptionWord();
+			n_tokens = 0;
+		};
+
+		for (auto &token : segment.tokens) {
+			bool complete = CompleteUtf8Length(word.text) == word.text.size();
+			bool starts_word = by_token || (!token.text.empty() && token.text[0] == ' ');
+			if (n_tokens == 0 || (complete && starts_word)) {
+				flush();
+				word.segment_id = segment.segment_id;
+				word.start_time = token.start_time;
+				word.probability = 0.0;
+			}
+			word.text += token.text;
+			word.end_time = token.end_time;
+			word.probability += token.probability;
+			n_tokens++;
+		}
+		flush();
+	}
+}
+
+static void TranscribeWordsExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<TranscribeSegmentsBindData>();
+	auto &state = data.global_state->Cast<TranscribeSegmentsState>();
+	auto &local = data.local_state->Cast<TranscribeSegmentsLocalState>();
+
+	while (local.current_word >= local.words.size()) {
+		local.words.clear();
+		local.current_word = 0;
+		if (!LoadNextSegments(context, bind_data, state, local)) {
+			output.SetCardinality(0);
+			return;
+		}
+		SplitWords(local.segments, bind_data.token_granularity, local.words);
+		local.segments.clear();
+	}
+
+	// Output words (a chunk never spans two files); only the projected columns are filled
+	idx_t count = MinValue<idx_t>(local.words.size() - local.current_word, STANDARD_VECTOR_SIZE);
+	const auto *words = local.words.data() + local.current_word;
+
+	for (idx_t col = 0; col < state.column_ids.size(); col++) {
+		auto &vector = output.data[col];
+		switch (state.column_ids[col]) {
+		case WORDS_SEGMENT_ID: {
+			auto segment_id_data = FlatVector::GetData<int32_t>(vector);
+			for (idx_t i = 0; i < count; i++) {
+				segment_id_data[i] = words[i].segment_id;
+			}
+			break;
+		}
+		case WORDS_WORD_ID: {
+			auto word_id_data = FlatVector::GetData<int32_t>(vector);
+			for (idx_t i = 0; i < count; i++) {
+				word_id_data[i] = local.next_word_id + static_cast<int>(i);
+			}
+			break;
+		}
+		case WORDS_START_TIME: {
+			auto start_time_data = FlatVector::GetData<double>(vector);
+			for (idx_t i = 0; i < count; i++) {
+				start_time_data[i] = words[i].start_time;
+			}
+			break;
+		}
+		case WORDS_END_TIME: {
+			auto end_time_data = FlatVector::GetData<double>(vector);
+			for (idx_t i = 0; i < count; i++) {
+				end_time_data[i] = words[i].end_time;
+			}
+			break;
+		}
+		case WORDS_TEXT: {
+			auto text_data = FlatVector::GetData<string_t>(vector);
+			for (idx_t i = 0; i < count; i++) {
+				text_data[i] = StringVector::AddString(vector, words[i].text);
+			}
+			break;
+		}
+		case WORDS_PROBABILITY: {
+			auto probability_data = FlatVector::GetData<double>(vector);
+			for (idx_t i = 0; i < count; i++) {
+				probability_data[i] = words[i].probability;
+			}
+			break;
+		}
+		case WORDS_FILE_PATH:
+			SetFilePathVector(bind_data, local, vector);
+			break;
+		default:
+			// Row id requested without any real column (e.g. count(*))
+			vector.SetVectorType(VectorType::CONSTANT_VECTOR);
+			ConstantVector::SetNull(vector, true);
+			break;
+		}
+	}
+
+	local.next_word_id += static_cast<int>(count);
+	local.current_word += count;
+	output.SetCardinality(count);
+}
+
+// ============================================================================
+// Registration
+// ============================================================================
+
+static void AddTranscribeFunction(TableFunctionSet &set, vector<LogicalType> arguments, table_function_t execute,
+                                  table_function_bind_t bind, table_function_init_global_t init) {
+	TableFunction function(std::move(arguments), execute, bind, init, TranscribeSegmentsInitLocal);
+	function.named_parameters["format"] = LogicalType::VARCHAR;
+	function.named_parameters["beam_size"] = LogicalType::INTEGER;
+	function.named_parameters["best_of"] = LogicalType::INTEGER;
+	function.named_parameters["temperature"] = LogicalType::DOUBLE;
+	function.named_parameters["temperature_inc"] = LogicalType::DOUBLE;
+	function.named_parameters["entropy_thold"] = LogicalType::DOUBLE;
+	function.named_parameters["no_context"] = LogicalType::BOOLEAN;
+	function.named_parameters["audio_ctx"] = LogicalType::INTEGER;
+	set.AddFunction(function);
+}
 
-	// Version with file path, model, language, and translate
-	TableFunction tf3t({LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BOOLEAN},
-	                   TranscribeSegmentsExecute, TranscribeSegmentsBind, TranscribeSegmentsInit);
-	transcribe_segments_set.AddFunction(tf3t);
+static void AddTranscribeSegmentsFunction(TableFunctionSet &set, vector<LogicalType> arguments) {
+	AddTranscribeFunction(set, std::move(arguments), TranscribeSegmentsExecute, TranscribeSegmentsBind,
+	                      TranscribeSegmentsInit);
+	auto &function = set.functions.back();
+	function.projection_pushdown = true;
+	function.pushdown_complex_filter = TranscribeSegmentsPushdownFilter;
+}
+
+static void AddTranscribeWordsFunction(TableFunctionSet &set, vector<LogicalType> arguments) {
+	AddTranscribeFunction(set, std::move(arguments), TranscribeWordsExecute, TranscribeWordsBind,
+	                      TranscribeWordsInit);
+	auto &function = set.functions.back();
+	function.named_parameters["granularity"] = LogicalType::VARCHAR;
+	function.projection_pushdown = true;
+}
 
-	// BLOB versions
-	TableFunction tf4({LogicalType::BLOB}, TranscribeSegmentsExecute, TranscribeSegmentsBind, TranscribeSegmentsInit);
-	transcribe_segments_set.AddFunction(tf4);
+void RegisterTranscribeTableFunctions(ExtensionLoader &loader) {
+	// whisper_transcribe_segments(file_path VARCHAR, model? VARCHAR, language? VARCHAR, translate? BOOLEAN) -> TABLE
+	// file_path may be a glob pattern or a LIST of paths; files are transcribed in parallel
+	TableFunctionSet transcribe_segments_set("whisper_transcribe_segments");
 
-	TableFunction tf5({LogicalType::BLOB, LogicalType::VARCHAR}, TranscribeSegmentsExecute, TranscribeSegmentsBind,
-	                  TranscribeSegmentsInit);
-	transcribe_segments_set.AddFunction(tf5);
+	vector<LogicalType> input_types = {LogicalType::VARCHAR, LogicalType::LIST(LogicalType::VARCHAR),
+	                                   LogicalType::BLOB};
+	for (auto &input_type : input_types) {
+		// Version with just the input
+		AddTranscribeSegmentsFunction(transcribe_segments_set, {input_type});
 
-	TableFunction tf6({LogicalType::BLOB, LogicalType::VARCHAR, LogicalType::VARCHAR}, TranscribeSegmentsExecute,
-	                  TranscribeSegmentsBind, TranscribeSegmentsInit);
-	transcribe_segments_set.AddFunction(tf6);
+		// Version with input and model
+		AddTranscribeSegmentsFunction(transcribe_segments_set, {input_type, LogicalType::VARCHAR});
 
-	// BLOB version with translate
-	TableFunction tf6t({LogicalType::BLOB, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BOOLEAN},
-	                   TranscribeSegmentsExecute, TranscribeSegmentsBind, TranscribeSegmentsInit);
-	transcribe_segments_set.AddFunction(tf6t);
+		// Version with input, model, and language
+		AddTranscribeSegmentsFunction(transcribe_segments_set,
+		                              {input_type, LogicalType::VARCHAR, LogicalType::VARCHAR});
+
+		// Version with input, model, language, and translate
+		AddTranscribeSegmentsFunction(transcribe_segments_set,
+		                              {input_type, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BOOLEAN});
+	}
 
 	loader.RegisterFunction(transcribe_segments_set);
+
+	// whisper_transcribe_words(file_path VARCHAR, model? VARCHAR, language? VARCHAR, translate? BOOLEAN) -> TABLE
+	// One row per word (or token with granularity := 'token'); same inputs as whisper_transcribe_segments
+	TableFunctionSet transcribe_words_set("whisper_transcribe_words");
+	for (auto &input_type : input_types) {
+		AddTranscribeWordsFunction(transcribe_words_set, {input_type});
+		AddTranscribeWordsFunction(transcribe_words_set, {input_type, LogicalType::VARCHAR});
+		AddTranscribeWordsFunction(transcribe_words_set, {input_type, LogicalType::VARCHAR, LogicalType::VARCHAR});
+		AddTranscribeWordsFunction(transcribe_words_set,
+		                           {input_type, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BOOLEAN});
+	}
+
+	loader.RegisterFunction(transcribe_words_set);
 }
 
 } // namespace duckdb
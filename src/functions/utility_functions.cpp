@@ -5,9 +5,13 @@
 #include "duckdb/common/exception.hpp"
 
 #include "audio_utils.hpp"
+#include "transcription_cache.hpp"
+#include "transcription_stats.hpp"
 #include "whisper_config.hpp"
 #include "whisper.h"
 
+#include <atomic>
+
 namespace duckdb {
 
 // Extension version
@@ -52,29 +56,79 @@ static void WhisperCheckAudioFunction(DataChunk &args, ExpressionState &state, V
 	});
 }
 
+// ============================================================================
+// whisper_decode_audio(audio) - Decodes audio to 16kHz PCM without transcribing
+// ============================================================================
+
+// Returns the number of samples, which makes the decode stage measurable on its own
+static void WhisperDecodeAudioFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &context = state.GetContext();
+	auto config = WhisperConfigManager::GetConfig(context);
+	AudioUtils::SetFFmpegLogging(config.ffmpeg_logging);
+
+	bool is_blob = args.data[0].GetType().id() == LogicalTypeId::BLOB;
+	std::vector<float> pcm_data;
+
+	UnaryExecutor::Execute<string_t, int64_t>(args.data[0], result, args.size(), [&](string_t input) {
+		std::string error;
+		bool ok;
+		if (is_blob) {
+			ok = AudioUtils::LoadAudioFromMemory(reinterpret_cast<const uint8_t *>(input.GetData()), input.GetSize(),
+			                                     config.input_format, pcm_data, error);
+		} else {
+			ok = AudioUtils::LoadAudioFile(input.GetString(), config.input_format, pcm_data, error);
+		}
+		if (!ok) {
+			throw InvalidInputException("Failed to load audio: " + error);
+		}
+		return static_cast<int64_t>(pcm_data.size());
+	});
+}
+
 // ============================================================================
 // whisper_audio_info(file_path) - Table function with audio metadata
 // ============================================================================
 
+// Defined in transcribe_table.cpp
+void AddInputPaths(ClientContext &context, const std::string &path, std::vector<std::string> &file_paths);
+
+// Files handed to a thread at a time; header reads are cheap, so batches keep the atomic off the hot path
+static constexpr idx_t AUDIO_INFO_BATCH_SIZE = 64;
+
 struct AudioInfoBindData : public TableFunctionData {
-	std::string file_path;
+	std::vector<std::string> file_paths; // Expanded file list (globs and lists)
+	bool ignore_errors = false;          // Return NULL metadata for unreadable files instead of failing
 };
 
 struct AudioInfoState : public GlobalTableFunctionState {
-	bool returned;
+	std::atomic<idx_t> next_file;
+	idx_t max_threads;
 
-	AudioInfoState() : returned(false) {
+	AudioInfoState() : next_file(0), max_threads(1) {
 	}
 
 	idx_t MaxThreads() const override {
-		return 1;
+		return max_threads;
 	}
 };
 
 static unique_ptr<FunctionData> AudioInfoBind(ClientContext &context, TableFunctionBindInput &input,
                                               vector<LogicalType> &return_types, vector<string> &names) {
 	auto bind_data = make_uniq<AudioInfoBindData>();
-	bind_data->file_path = input.inputs[0].GetValue<string>();
+	if (input.inputs[0].type().id() == LogicalTypeId::LIST) {
+		for (auto &path : ListValue::GetChildren(input.inputs[0])) {
+			if (!path.IsNull()) {
+				AddInputPaths(context, path.GetValue<string>(), bind_data->file_paths);
+			}
+		}
+	} else {
+		AddInputPaths(context, input.inputs[0].GetValue<string>(), bind_data->file_paths);
+	}
+
+	auto ignore_errors_entry = input.named_parameters.find("ignore_errors");
+	if (ignore_errors_entry != input.named_parameters.end() && !ignore_errors_entry->second.IsNull()) {
+		bind_data->ignore_errors = BooleanValue::Get(ignore_errors_entry->second);
+	}
 
 	return_types.push_back(LogicalType::VARCHAR); // file_path
 	names.push_back("file_path");
@@ -98,35 +152,289 @@ static unique_ptr<FunctionData> AudioInfoBind(ClientContext &context, TableFunct
 }
 
 static unique_ptr<GlobalTableFunctionState> AudioInfoInit(ClientContext &context, TableFunctionInitInput &input) {
-	return make_uniq<AudioInfoState>();
+	auto &bind_data = input.bind_data->Cast<AudioInfoBindData>();
+	auto state = make_uniq<AudioInfoState>();
+	idx_t n_batches = (bind_data.file_paths.size() + AUDIO_INFO_BATCH_SIZE - 1) / AUDIO_INFO_BATCH_SIZE;
+	state->max_threads = MaxValue<idx_t>(n_batches, 1);
+
+	// Configure FFmpeg logging based on settings
+	auto config = WhisperConfigManager::GetConfig(context);
+	AudioUtils::SetFFmpegLogging(config.ffmpeg_logging);
+	return std::move(state);
 }
 
 static void AudioInfoExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
 	auto &bind_data = data.bind_data->Cast<AudioInfoBindData>();
 	auto &state = data.global_state->Cast<AudioInfoState>();
 
+	idx_t n_files = bind_data.file_paths.size();
+	idx_t begin = state.next_file.fetch_add(AUDIO_INFO_BATCH_SIZE);
+	if (begin >= n_files) {
+		output.SetCardinality(0);
+		return;
+	}
+	idx_t count = MinValue<idx_t>(n_files - begin, AUDIO_INFO_BATCH_SIZE);
+
+	auto file_path_data = FlatVector::GetData<string_t>(output.data[0]);
+	auto duration_data = FlatVector::GetData<double>(output.data[1]);
+	auto sample_rate_data = FlatVector::GetData<int32_t>(output.data[2]);
+	auto channels_data = FlatVector::GetData<int32_t>(output.data[3]);
+	auto format_data = FlatVector::GetData<string_t>(output.data[4]);
+	auto file_size_data = FlatVector::GetData<int64_t>(output.data[5]);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto &file_path = bind_data.file_paths[begin + i];
+		file_path_data[i] = StringVector::AddString(output.data[0], file_path);
+
+		AudioMetadata metadata;
+		std::string error;
+		if (!AudioUtils::GetAudioMetadata(file_path, metadata, error)) {
+			if (!bind_data.ignore_errors) {
+				throw InvalidInputException("Failed to read audio info: " + error);
+			}
+			for (idx_t col = 1; col < output.ColumnCount(); col++) {
+				FlatVector::SetNull(output.data[col], i, true);
+			}
+			continue;
+		}
+
+		duration_data[i] = metadata.duration_seconds;
+		sample_rate_data[i] = metadata.sample_rate;
+		channels_data[i] = metadata.channels;
+		format_data[i] = StringVector::AddString(output.data[4], metadata.format);
+		file_size_data[i] = metadata.file_size;
+	}
+
+	output.SetCardinality(count);
+}
+
+// ============================================================================
+// whisper_cache_stats() - Table function with transcription cache counters
+// ============================================================================
+
+struct CacheStatsState : public GlobalTableFunctionState {
+	bool returned;
+
+	CacheStatsState() : returned(false) {
+	}
+
+	idx_t MaxThreads() const override {
+		return 1;
+	}
+};
+
+static unique_ptr<FunctionData> CacheStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                               vector<LogicalType> &return_types, vector<string> &names) {
+	return_types.push_back(LogicalType::BIGINT); // hits
+	names.push_back("hits");
+
+	return_types.push_back(LogicalType::BIGINT); // misses
+	names.push_back("misses");
+
+	return_types.push_back(LogicalType::BIGINT); // disk_hits
+	names.push_back("disk_hits");
+
+	return_types.push_back(LogicalType::BIGINT); // entries
+	names.push_back("entries");
+
+	return_types.push_back(LogicalType::BIGINT); // capacity
+	names.push_back("capacity");
+
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> CacheStatsInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<CacheStatsState>();
+}
+
+static void CacheStatsExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<CacheStatsState>();
+
 	if (state.returned) {
 		output.SetCardinality(0);
 		return;
 	}
 
-	// Configure FFmpeg logging based on settings
-	auto config = WhisperConfigManager::GetConfig(context);
-	AudioUtils::SetFFmpegLogging(config.ffmpeg_logging);
+	auto stats = TranscriptionCache::GetInstance().GetStats();
+
+	output.SetValue(0, 0, Value::BIGINT(stats.hits));
+	output.SetValue(1, 0, Value::BIGINT(stats.misses));
+	output.SetValue(2, 0, Value::BIGINT(stats.disk_hits));
+	output.SetValue(3, 0, Value::BIGINT(stats.entries));
+	output.SetValue(4, 0, Value::BIGINT(stats.capacity));
 
-	AudioMetadata metadata;
-	std::string error;
+	output.SetCardinality(1);
+	state.returned = true;
+}
+
+// ============================================================================
+// whisper_stats() - Table function with cumulative transcription counters per model
+// ============================================================================
+
+struct StatsState : public GlobalTableFunctionState {
+	std::vector<ModelStats> models;
+	idx_t current_idx;
+
+	StatsState() : current_idx(0) {
+	}
+
+	idx_t MaxThreads() const override {
+		return 1;
+	}
+};
+
+static unique_ptr<FunctionData> StatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                          vector<LogicalType> &return_types, vector<string> &names) {
+	return_types.push_back(LogicalType::VARCHAR); // model
+	names.push_back("model");
+
+	return_types.push_back(LogicalType::BIGINT); // calls
+	names.push_back("calls");
+
+	return_types.push_back(LogicalType::BIGINT); // cache_hits
+	names.push_back("cache_hits");
 
-	if (!AudioUtils::GetAudioMetadata(bind_data.file_path, metadata, error)) {
-		throw InvalidInputException("Failed to read audio info: " + error);
+	return_types.push_back(LogicalType::BIGINT); // context_loads
+	names.push_back("context_loads");
+
+	return_types.push_back(LogicalType::DOUBLE); // audio_hours
+	names.push_back("audio_hours");
+
+	return_types.push_back(LogicalType::DOUBLE); // audio_decode_seconds
+	names.push_back("audio_decode_seconds");
+
+	return_types.push_back(LogicalType::DOUBLE); // inference_seconds
+	names.push_back("inference_seconds");
+
+	return_types.push_back(LogicalType::DOUBLE); // model_load_seconds
+	names.push_back("model_load_seconds");
+
+	return_types.push_back(LogicalType::DOUBLE); // real_time_factor
+	names.push_back("real_time_factor");
+
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> StatsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto state = make_uniq<StatsState>();
+	state->models = TranscriptionStats::GetInstance().GetModelStats();
+	return std::move(state);
+}
+
+static void StatsExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<StatsState>();
+
+	idx_t output_idx = 0;
+	while (state.current_idx < state.models.size() && output_idx < STANDARD_VECTOR_SIZE) {
+		const auto &model = state.models[state.current_idx];
+		double processing_seconds = (model.audio_decode_ms + model.inference_ms) / 1000.0;
+
+		output.SetValue(0, output_idx, Value(model.model));
+		output.SetValue(1, output_idx, Value::BIGINT(model.calls));
+		output.SetValue(2, output_idx, Value::BIGINT(model.cache_hits));
+		output.SetValue(3, output_idx, Value::BIGINT(model.context_loads));
+		output.SetValue(4, output_idx, Value::DOUBLE(model.audio_seconds / 3600.0));
+		output.SetValue(5, output_idx, Value::DOUBLE(model.audio_decode_ms / 1000.0));
+		output.SetValue(6, output_idx, Value::DOUBLE(model.inference_ms / 1000.0));
+		output.SetValue(7, output_idx, Value::DOUBLE(model.model_load_ms / 1000.0));
+		output.SetValue(8, output_idx,
+		                model.audio_seconds > 0.0 ? Value::DOUBLE(processing_seconds / model.audio_seconds) : Value());
+
+		state.current_idx++;
+		output_idx++;
 	}
 
-	output.SetValue(0, 0, Value(bind_data.file_path));
-	output.SetValue(1, 0, Value::DOUBLE(metadata.duration_seconds));
-	output.SetValue(2, 0, Value::INTEGER(metadata.sample_rate));
-	output.SetValue(3, 0, Value::INTEGER(metadata.channels));
-	output.SetValue(4, 0, Value(metadata.format));
-	output.SetValue(5, 0, Value::BIGINT(metadata.file_size));
+	output.SetCardinality(output_idx);
+}
+
+// ============================================================================
+// whisper_last_profile() - Table function with the stage timings of the last transcription
+// ============================================================================
+
+struct LastProfileState : public GlobalTableFunctionState {
+	bool returned;
+
+	LastProfileState() : returned(false) {
+	}
+
+	idx_t MaxThreads() const override {
+		return 1;
+	}
+};
+
+static unique_ptr<FunctionData> LastProfileBind(ClientContext &context, TableFunctionBindInput &input,
+                                                vector<LogicalType> &return_types, vector<string> &names) {
+	return_types.push_back(LogicalType::VARCHAR); // model
+	names.push_back("model");
+
+	return_types.push_back(LogicalType::BOOLEAN); // cache_hit
+	names.push_back("cache_hit");
+
+	return_types.push_back(LogicalType::INTEGER); // threads
+	names.push_back("threads");
+
+	return_types.push_back(LogicalType::INTEGER); // threads_in_use
+	names.push_back("threads_in_use");
+
+	return_types.push_back(LogicalType::DOUBLE); // audio_seconds
+	names.push_back("audio_seconds");
+
+	return_types.push_back(LogicalType::DOUBLE); // audio_decode_ms
+	names.push_back("audio_decode_ms");
+
+	return_types.push_back(LogicalType::DOUBLE); // model_load_ms
+	names.push_back("model_load_ms");
+
+	return_types.push_back(LogicalType::DOUBLE); // mel_ms
+	names.push_back("mel_ms");
+
+	return_types.push_back(LogicalType::DOUBLE); // encode_ms
+	names.push_back("encode_ms");
+
+	return_types.push_back(LogicalType::DOUBLE); // decode_ms
+	names.push_back("decode_ms");
+
+	return_types.push_back(LogicalType::DOUBLE); // inference_ms
+	names.push_back("inference_ms");
+
+	return_types.push_back(LogicalType::DOUBLE); // total_ms
+	names.push_back("total_ms");
+
+	return_types.push_back(LogicalType::DOUBLE); // real_time_factor
+	names.push_back("real_time_factor");
+
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> LastProfileInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<LastProfileState>();
+}
+
+static void LastProfileExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<LastProfileState>();
+
+	std::string model;
+	TranscriptionProfile profile;
+	if (state.returned || !TranscriptionStats::GetLastProfile(context, model, profile)) {
+		output.SetCardinality(0);
+		return;
+	}
+
+	output.SetValue(0, 0, Value(model));
+	output.SetValue(1, 0, Value::BOOLEAN(profile.cache_hit));
+	output.SetValue(2, 0, Value::INTEGER(profile.threads));
+	output.SetValue(3, 0, Value::INTEGER(profile.threads_in_use));
+	output.SetValue(4, 0, Value::DOUBLE(profile.audio_seconds));
+	output.SetValue(5, 0, Value::DOUBLE(profile.audio_decode_ms));
+	output.SetValue(6, 0, Value::DOUBLE(profile.model_load_ms));
+	output.SetValue(7, 0, Value::DOUBLE(profile.mel_ms));
+	output.SetValue(8, 0, Value::DOUBLE(profile.encode_ms));
+	output.SetValue(9, 0, Value::DOUBLE(profile.decode_ms));
+	output.SetValue(10, 0, Value::DOUBLE(profile.inference_ms));
+	output.SetValue(11, 0, Value::DOUBLE(profile.total_ms));
+	output.SetValue(12, 0,
+	                profile.audio_seconds > 0.0 ? Value::DOUBLE(profile.total_ms / 1000.0 / profile.audio_seconds)
+	                                            : Value());
 
 	output.SetCardinality(1);
 	state.returned = true;
@@ -203,18 +511,24 @@ static void WhisperGetConfigFunction(DataChunk &args, ExpressionState &state, Ve
 	std::string device_str = config.device_id < 0 ? "default" : std::to_string(config.device_id);
 	std::string config_str = "model=" + config.model + ", model_path=" + config.model_path +
 	                         ", language=" + config.language + ", threads=" + std::to_string(config.threads) +
+	                         ", threads_policy=" + config.threads_policy +
+	                         ", max_concurrent_states=" + std::to_string(config.max_concurrent_states) +
+	                         ", cache=" + (config.cache ? "true" : "false") +
 	                         ", translate=" + (config.translate ? "true" : "false") + ", device_id=" + device_str +
 	                         ", max_duration=" + std::to_string(config.max_duration) +
 	                         ", silence_duration=" + std::to_string(config.silence_duration) +
 	                         ", silence_threshold=" + std::to_string(config.silence_threshold) +
 	                         ", verbose=" + (config.verbose ? "true" : "false") +
 	                         ", ffmpeg_logging=" + (config.ffmpeg_logging ? "true" : "false") +
-	                         ", use_gpu=" + (config.use_gpu ? "true" : "false");
+	                         ", use_gpu=" + (config.use_gpu ? "true" : "false") +
+	                         ", gpu_device=" + (config.gpu_device < 0 ? "auto" : std::to_string(config.gpu_device));
 
 #ifdef WHISPER_ENABLE_VOICE_QUERY
 	config_str += ", text_to_sql_url=" + config.text_to_sql_url +
 	              ", text_to_sql_timeout=" + std::to_string(config.text_to_sql_timeout) +
-	              ", voice_query_show_sql=" + (config.voice_query_show_sql ? "true" : "false");
+	              ", text_to_sql_compress=" + (config.text_to_sql_compress ? "true" : "false") +
+	              ", voice_query_show_sql=" + (config.voice_query_show_sql ? "true" : "false") +
+	              ", voice_query_max_tables=" + std::to_string(config.voice_query_max_tables);
 #endif
 
 	result.SetVectorType(VectorType::CONSTANT_VECTOR);
@@ -284,10 +598,32 @@ void RegisterUtilityFunctions(ExtensionLoader &loader) {
 	    ScalarFunction("whisper_check_audio", {LogicalType::VARCHAR}, LogicalType::VARCHAR, WhisperCheckAudioFunction);
 	loader.RegisterFunction(check_func);
 
-	// whisper_audio_info(file_path)
-	TableFunction audio_info("whisper_audio_info", {LogicalType::VARCHAR}, AudioInfoExecute, AudioInfoBind,
-	                         AudioInfoInit);
-	loader.RegisterFunction(audio_info);
+	// whisper_decode_audio(file_path | audio_data)
+	ScalarFunctionSet decode_set("whisper_decode_audio");
+	decode_set.AddFunction(ScalarFunction({LogicalType::VARCHAR}, LogicalType::BIGINT, WhisperDecodeAudioFunction));
+	decode_set.AddFunction(ScalarFunction({LogicalType::BLOB}, LogicalType::BIGINT, WhisperDecodeAudioFunction));
+	loader.RegisterFunction(decode_set);
+
+	// whisper_audio_info(file_path | file_paths) - file_path may be a glob pattern; files are read in parallel
+	TableFunctionSet audio_info_set("whisper_audio_info");
+	for (auto &input_type : {LogicalType::VARCHAR, LogicalType::LIST(LogicalType::VARCHAR)}) {
+		TableFunction audio_info({input_type}, AudioInfoExecute, AudioInfoBind, AudioInfoInit);
+		audio_info.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+		audio_info_set.AddFunction(audio_info);
+	}
+	loader.RegisterFunction(audio_info_set);
+
+	// whisper_cache_stats()
+	TableFunction cache_stats("whisper_cache_stats", {}, CacheStatsExecute, CacheStatsBind, CacheStatsInit);
+	loader.RegisterFunction(cache_stats);
+
+	// whisper_stats()
+	TableFunction stats("whisper_stats", {}, StatsExecute, StatsBind, StatsInit);
+	loader.RegisterFunction(stats);
+
+	// whisper_last_profile()
+	TableFunction last_profile("whisper_last_profile", {}, LastProfileExecute, LastProfileBind, LastProfileInit);
+	loader.RegisterFunction(last_profile);
 
 	// Configuration getter functions
 	auto get_device_id = ScalarFunction("whisper_get_device_id", {}, LogicalType::INTEGER, WhisperGetDeviceIdFunction);
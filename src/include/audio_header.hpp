@@ -0,0 +1,26 @@
+#pragma once
+
+#include "audio_utils.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace duckdb {
+
+// Reads audio metadata from the container header alone for PCM/float WAV, FLAC and MP3
+// No stream probing or decoding, so metadata of large archives can be gathered quickly.
+class AudioHeaderReader {
+public:
+	// Memory-map a file and parse its header; returns false to request the FFmpeg path
+	static bool ReadFile(const std::string &file_path, AudioMetadata &metadata);
+
+	// Parse an in-memory header (size is the whole file); returns false to request the FFmpeg path
+	static bool ReadMemory(const uint8_t *data, size_t size, AudioMetadata &metadata);
+
+private:
+	static bool ReadWav(const uint8_t *data, size_t size, AudioMetadata &metadata);
+	static bool ReadFlac(const uint8_t *data, size_t size, AudioMetadata &metadata);
+	static bool ReadMp3(const uint8_t *data, size_t size, AudioMetadata &metadata);
+};
+
+} // namespace duckdb
@@ -2,11 +2,15 @@
 
 #ifdef WHISPER_ENABLE_RECORDING
 
+#include "sample_ring_buffer.hpp"
+
 #include <string>
 #include <vector>
 #include <functional>
 #include <atomic>
 #include <cstdint>
+#include <mutex>
+#include <thread>
 
 namespace duckdb {
 
@@ -30,6 +34,19 @@ public:
 	// Stop recording and return PCM data (16kHz mono float32)
 	bool StopRecording(std::vector<float> &pcm_data, std::string &error);
 
+	// Stop the device; audio captured so far stays available to TakeCaptured
+	void Stop();
+
+	// Keep recording for up to seconds (audio is moved out of the ring buffer by a drain thread meanwhile)
+	// Returns true if it stopped early because the armed silence stop fired (see SetSilenceStop).
+	bool Capture(double seconds);
+
+	// Make Capture return once silence_duration_sec of silence follows speech
+	void SetSilenceStop(float silence_threshold, double silence_duration_sec);
+
+	// Append the audio captured since the last call to pcm_data (consumer thread only)
+	void TakeCaptured(std::vector<float> &pcm_data);
+
 	// Record with automatic stop on silence
 	// max_duration_sec: maximum recording time
 	// silence_threshold: amplitude threshold (0.0-1.0), default 0.01
@@ -43,19 +60,40 @@ public:
 	// Get current recording duration in seconds
 	double GetRecordingDuration() const;
 
+	// Microphone samples lost because the ring buffer was full (0 unless the drain thread stalls)
+	size_t DroppedSamples() const;
+
 private:
 	static void AudioCallback(void *userdata, unsigned char *stream, int len);
 
-	uint32_t device_id_; // SDL_AudioDeviceID
-	std::vector<float> buffer_;
+	// Move audio from the ring buffer into buffer_ (drain thread while recording, then the caller after Stop)
+	void Drain();
+
+	// Drain every DRAIN_INTERVAL_MS until recording stops, independent of how long the caller's work takes
+	void DrainLoop();
+
+	// Whether the armed silence stop should fire, given the latest amplitude
+	bool SilenceElapsed();
+
+	static constexpr size_t RING_CAPACITY = 1 << 17; // ~8 seconds at 16kHz, drained every 50ms
+	static constexpr int DRAIN_INTERVAL_MS = 50;
+
+	uint32_t device_id_;              // SDL_AudioDeviceID
+	SampleRingBuffer ring_;           // Written by the SDL audio thread, read by the drain thread
+	std::thread drain_thread_;        // Runs DrainLoop while recording
+	mutable std::mutex buffer_mutex_; // Guards buffer_ and taken_samples_
+	std::vector<float> buffer_;       // Drained audio not yet taken
+	size_t taken_samples_;            // Samples already handed out by TakeCaptured
+	std::atomic<size_t> dropped_samples_;
 	std::atomic<bool> recording_;
 	int sample_rate_;
 
 	// Silence detection
 	std::atomic<float> current_amplitude_;
 	float silence_threshold_;
-	double silence_duration_sec_;
-	double silence_start_time_;
+	double silence_duration_sec_; // 0 = no silence stop
+	double silence_start_time_;   // Recording time at which the current silence began (-1 = sound)
+	bool had_sound_;              // Silence only counts after speech
 	std::atomic<bool> silence_detected_;
 
 	static bool sdl_initialized_;
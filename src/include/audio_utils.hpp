@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <memory>
 
 namespace duckdb {
 
@@ -17,10 +18,21 @@ struct AudioMetadata {
 class AudioUtils {
 public:
 	// Load audio from file and convert to 16kHz mono float32 PCM (whisper requirement)
-	static bool LoadAudioFile(const std::string &file_path, std::vector<float> &output, std::string &error);
+	// format is an optional container hint (e.g. "wav"); empty = probe the input
+	static bool LoadAudioFile(const std::string &file_path, const std::string &format, std::vector<float> &output,
+	                          std::string &error);
 
 	// Load audio from memory buffer and convert to 16kHz mono float32 PCM
-	static bool LoadAudioFromMemory(const uint8_t *data, size_t size, std::vector<float> &output, std::string &error);
+	static bool LoadAudioFromMemory(const uint8_t *data, size_t size, const std::string &format,
+	                                std::vector<float> &output, std::string &error);
+
+	// Decode only [start_seconds, end_seconds) of the input (end_seconds < 0 = to the end)
+	// The demuxer seeks to start_seconds instead of decoding everything before it.
+	static bool LoadAudioFileRange(const std::string &file_path, const std::string &format, double start_seconds,
+	                               double end_seconds, std::vector<float> &output, std::string &error);
+	static bool LoadAudioFromMemoryRange(const uint8_t *data, size_t size, const std::string &format,
+	                                     double start_seconds, double end_seconds, std::vector<float> &output,
+	                                     std::string &error);
 
 	// Get audio metadata without fully decoding
 	static bool GetAudioMetadata(const std::string &file_path, AudioMetadata &metadata, std::string &error);
@@ -30,9 +42,43 @@ public:
 
 	// Configure FFmpeg logging (true = AV_LOG_INFO, false = AV_LOG_QUIET)
 	static void SetFFmpegLogging(bool enabled);
+};
+
+// Incremental decoder producing 16kHz mono float32 PCM
+// Lets long recordings be processed window by window instead of decoding the whole file up front.
+class AudioStreamReader {
+public:
+	AudioStreamReader();
+	~AudioStreamReader();
+
+	AudioStreamReader(const AudioStreamReader &) = delete;
+	AudioStreamReader &operator=(const AudioStreamReader &) = delete;
+
+	// Open an audio file for decoding (format: optional container hint, empty = probe)
+	bool OpenFile(const std::string &file_path, const std::string &format, std::string &error);
+
+	// Open an in-memory audio buffer for decoding (buffer must outlive the reader)
+	bool OpenMemory(const uint8_t *data, size_t size, const std::string &format, std::string &error);
+
+	// Append up to max_samples decoded samples to output
+	bool Read(std::vector<float> &output, size_t max_samples, std::string &error);
+
+	// Decode the remaining audio into output (replacing its contents)
+	bool ReadAll(std::vector<float> &output, std::string &error);
+
+	// Continue decoding at the given time (before any Read); the next sample returned is the one at seconds
+	// Inputs that cannot seek are decoded from the start and the audio before seconds is dropped.
+	void Seek(double seconds);
+
+	// True once all audio has been returned by Read
+	bool IsFinished() const;
+
+	// Container duration in seconds (0 if unknown)
+	double GetDuration() const;
 
 private:
-	static constexpr int WHISPER_SAMPLE_RATE = 16000;
+	struct Impl;
+	std::unique_ptr<Impl> impl_;
 };
 
 } // namespace duckdb
@@ -0,0 +1,36 @@
+#pragma once
+
+#ifdef WHISPER_ENABLE_VOICE_QUERY
+
+#include "duckdb.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// One table's DDL and the words it can be matched by
+struct TableDDL {
+	std::string sql;                       // CREATE TABLE statement
+	std::vector<std::string> name_words;   // Normalized words of the table name (sorted, unique)
+	std::vector<std::string> column_words; // Normalized words of the column names (sorted, unique)
+};
+
+// Tables of every attached database, as sent to the text-to-sql proxy
+struct DatabaseSchema {
+	// One list per catalog; lists are shared with the extraction cache
+	std::vector<std::shared_ptr<const std::vector<TableDDL>>> catalogs;
+
+	// DDL of all tables, or with max_tables > 0 only the tables that best match the question's words
+	// (table name matches outweigh column matches; catalog order breaks ties)
+	std::string ToDDL(const std::string &question, idx_t max_tables) const;
+};
+
+// Read the tables of all attached databases through the catalog API (not thread-safe: call on the context's thread)
+// Each catalog is rescanned only when its catalog version changes.
+DatabaseSchema ExtractDatabaseSchema(ClientContext &context);
+
+} // namespace duckdb
+
+#endif // WHISPER_ENABLE_VOICE_QUERY
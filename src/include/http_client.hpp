@@ -14,15 +14,27 @@ struct HttpResponse {
 	long status_code = 0;
 };
 
+// Client for the text-to-sql proxy
+// Curl handles come from a process-wide pool and go back to it on destruction, so their open
+// connections (kept alive, HTTP/2 over TLS where the proxy supports it) and DNS and TLS session
+// caches are reused by later voice queries.
 class HttpClient {
 public:
 	HttpClient();
 	~HttpClient();
 
-	// Perform HTTP POST with JSON body
-	HttpResponse Post(const std::string &url, const std::string &json_body, int32_t timeout_seconds = 30);
+	// Perform HTTP POST with JSON body; compress gzips the body (needs zlib at build time)
+	HttpResponse Post(const std::string &url, const std::string &json_body, int32_t timeout_seconds = 30,
+	                  bool compress = false);
+
+	// Resolve the host and open (and TLS-handshake) a connection that a following Post reuses
+	// Failures are ignored; Post reports them when it runs.
+	void Warmup(const std::string &url);
 
 private:
+	// Options shared by Post and Warmup; they must match for the warm connection to be reused
+	void SetCommonOptions(const std::string &url, int32_t timeout_seconds);
+
 	void *curl_handle;
 };
 
@@ -0,0 +1,68 @@
+#pragma once
+
+#ifdef WHISPER_ENABLE_RECORDING
+
+#include "audio_recorder.hpp"
+#include "transcription_engine.hpp"
+#include "whisper_config.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// A segment of live transcription; unsettled segments may still change as more audio arrives
+struct LiveSegment {
+	TranscriptionSegment segment;
+	bool is_final;
+};
+
+// Transcribes microphone input while it is still being recorded
+// Every step, the audio after the last settled segment is transcribed again. Segments that end well before the
+// live edge are settled and their audio is dropped, so inference overlaps with recording and the work left once
+// recording stops is only the unsettled tail.
+class LiveTranscriber {
+public:
+	static constexpr double DEFAULT_STEP_SECONDS = 2.0; // New audio between whisper runs
+
+	LiveTranscriber(const WhisperConfig &config, double step_seconds);
+
+	// Start recording; max_seconds bounds the recording, silence_seconds > 0 also stops it after speech ends
+	bool Start(int device_id, double max_seconds, double silence_seconds, std::string &error);
+
+	// Record the next step and transcribe; appends settled segments (and the unsettled tail if partials is set)
+	// Returns false when recording has stopped and everything was transcribed, or on error (error is set)
+	bool Next(std::vector<LiveSegment> &segments, bool partials, std::string &error);
+
+	// Record until stopped and return the settled text (for record-then-act callers such as voice queries)
+	bool TranscribeUntilStopped(std::string &text, std::string &error);
+
+	// Profile of the whole recording, summed over the steps; complete once Next() returned false without error
+	const TranscriptionProfile &Profile() const {
+		return profile_;
+	}
+
+private:
+	// Transcribe pending_ and settle what is stable (everything when flush is set)
+	bool TranscribePending(bool flush, std::vector<LiveSegment> &segments, bool partials, std::string &error);
+
+	// Stop and record the whole recording as one call in whisper_stats()
+	void Finish();
+
+	WhisperConfig config_;
+	double step_seconds_;
+	double max_seconds_;
+	AudioRecorder recorder_;
+	std::chrono::steady_clock::time_point start_time_;
+	std::vector<float> pending_; // Recorded audio after the last settled segment
+	size_t pending_start_;       // Sample offset of pending_[0] in the recording
+	int next_segment_id_;
+	TranscriptionProfile profile_; // Summed over the steps; re-transcribed audio counts once
+	bool recording_;
+	bool finished_;
+};
+
+} // namespace duckdb
+
+#endif // WHISPER_ENABLE_RECORDING
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace duckdb {
+
+// Read-only memory mapping of a whole file
+// Data() is nullptr when the file cannot be opened or mapped (callers fall back to regular reads).
+class MappedFile {
+public:
+	explicit MappedFile(const std::string &file_path);
+	~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	const uint8_t *Data() const {
+		return data_;
+	}
+	size_t Size() const {
+		return size_;
+	}
+
+private:
+	const uint8_t *data_ = nullptr;
+	size_t size_ = 0;
+#ifdef _WIN32
+	void *file_ = nullptr; // HANDLEs, kept opaque so this header does not pull in windows.h
+	void *mapping_ = nullptr;
+#endif
+};
+
+} // namespace duckdb
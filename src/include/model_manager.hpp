@@ -7,11 +7,13 @@
 namespace duckdb {
 
 struct ModelInfo {
-	std::string name;        // Model name (e.g., "base.en")
-	std::string file_path;   // Full path to model file
-	int64_t file_size;       // File size in bytes
-	bool is_downloaded;      // Whether the model exists locally
-	std::string description; // Model description
+	std::string name;         // Model name (e.g., "base.en")
+	std::string file_path;    // Full path to model file
+	int64_t file_size;        // File size in bytes
+	bool is_downloaded;       // Whether the model exists locally
+	std::string description;  // Model description
+	int64_t download_size;    // Approximate download size in bytes
+	std::string quantization; // Weight type ("f16", "q5_0", "q5_1", "q8_0")
 };
 
 class ModelManager {
@@ -19,6 +21,9 @@ public:
 	// Available model names
 	static const std::vector<std::string> &GetAvailableModels();
 
+	// Weight type encoded in the model name ("f16" for the unquantized models)
+	static std::string GetQuantization(const std::string &model_name);
+
 	// Get HuggingFace URL for model
 	static std::string GetModelUrl(const std::string &model_name);
 
@@ -37,13 +42,18 @@ public:
 	// List all models with download status
 	static std::vector<ModelInfo> ListModels(const std::string &base_path);
 
-	// Download model from HuggingFace
+	// Download model from HuggingFace (resumable via a .part file, verified against the published SHA-256)
 	static bool DownloadModel(const std::string &model_name, const std::string &base_path, std::string &error);
 
 	// Validate model name
 	static bool IsValidModelName(const std::string &model_name);
 
 private:
+#ifdef WHISPER_ENABLE_MODEL_DOWNLOAD
+	// Fetch url into target_path through a resumable, checksum-verified .part file
+	static bool DownloadFile(const std::string &url, const std::string &target_path, std::string &error);
+#endif
+
 	static constexpr const char *HUGGINGFACE_BASE_URL = "https://huggingface.co/ggerganov/whisper.cpp/resolve/main/";
 };
 
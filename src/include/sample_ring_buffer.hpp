@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace duckdb {
+
+// Fixed-size single-producer single-consumer ring buffer of audio samples
+// Lock-free and allocation-free after construction, so it is safe to write from a real-time audio callback.
+// Exactly one thread may call Write and exactly one (other) thread may call Read.
+class SampleRingBuffer {
+public:
+	// Capacity is rounded up to a power of two
+	explicit SampleRingBuffer(size_t capacity) : head_(0), tail_(0) {
+		size_t size = 1;
+		while (size < capacity) {
+			size <<= 1;
+		}
+		buffer_.resize(size);
+		mask_ = size - 1;
+	}
+
+	SampleRingBuffer(const SampleRingBuffer &) = delete;
+	SampleRingBuffer &operator=(const SampleRingBuffer &) = delete;
+
+	// Producer: append up to count samples; returns how many fit (the rest are dropped)
+	size_t Write(const float *samples, size_t count) {
+		size_t head = head_.load(std::memory_order_relaxed);
+		size_t tail = tail_.load(std::memory_order_acquire);
+		size_t free_space = buffer_.size() - (head - tail);
+		if (count > free_space) {
+			count = free_space;
+		}
+		for (size_t i = 0; i < count; i++) {
+			buffer_[(head + i) & mask_] = samples[i];
+		}
+		head_.store(head + count, std::memory_order_release);
+		return count;
+	}
+
+	// Consumer: append everything buffered to output; returns the number of samples moved
+	size_t Read(std::vector<float> &output) {
+		size_t tail = tail_.load(std::memory_order_relaxed);
+		size_t head = head_.load(std::memory_order_acquire);
+		size_t count = head - tail;
+		output.reserve(output.size() + count);
+		for (size_t i = 0; i < count; i++) {
+			output.push_back(buffer_[(tail + i) & mask_]);
+		}
+		tail_.store(head, std::memory_order_release);
+		return count;
+	}
+
+	// Samples currently buffered (exact only when called from the producer or the consumer)
+	size_t Size() const {
+		return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+	}
+
+	// Consumer: drop everything buffered
+	void Clear() {
+		tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+	}
+
+private:
+	std::vector<float> buffer_;
+	size_t mask_;
+	std::atomic<size_t> head_; // Total samples written (producer-owned)
+	std::atomic<size_t> tail_; // Total samples read (consumer-owned)
+};
+
+} // namespace duckdb
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace duckdb {
+
+// Incremental SHA-256 (FIPS 180-4), used to verify downloaded model files
+class SHA256 {
+public:
+	SHA256();
+
+	void Update(const uint8_t *data, size_t size);
+
+	// Finish the digest and return it as 64 lowercase hex characters
+	std::string FinalizeHex();
+
+private:
+	void Transform(const uint8_t *block);
+
+	uint32_t state_[8];
+	uint64_t total_bytes_;
+	uint8_t buffer_[64];
+	size_t buffer_size_;
+};
+
+} // namespace duckdb
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "transcription_engine.hpp"
+#include "whisper_config.hpp"
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+
+struct TranscriptionCacheStats {
+	int64_t hits;      // Lookups served from memory or disk
+	int64_t misses;    // Lookups that had to decode and transcribe
+	int64_t disk_hits; // Subset of hits loaded from the on-disk cache
+	int64_t entries;   // Results currently held in memory
+	int64_t capacity;  // Current in-memory entry limit
+};
+
+// LRU cache of transcription results (singleton, shared by all connections)
+// Keys combine an audio identity (path+mtime+size or SHA-256 of the content) with the decode parameters.
+class TranscriptionCache {
+public:
+	static TranscriptionCache &GetInstance();
+
+	// Build a cache key for a local file; returns false if the file cannot be stat'ed
+	static bool FileKey(const std::string &file_path, const WhisperConfig &config, std::string &key);
+
+	// Build a cache key for in-memory audio from a hash of its content
+	static std::string MemoryKey(const uint8_t *data, size_t size, const WhisperConfig &config);
+
+	// Look up a cached result (falls back to disk when whisper_cache_persist is enabled)
+	bool Lookup(const std::string &key, const WhisperConfig &config, TranscriptionResult &result);
+
+	// Store a successful result
+	void Store(const std::string &key, const WhisperConfig &config, const TranscriptionResult &result);
+
+	TranscriptionCacheStats GetStats();
+
+private:
+	TranscriptionCache() = default;
+	~TranscriptionCache() = default;
+
+	using Entry = std::pair<std::string, TranscriptionResult>;
+
+	void Insert(const std::string &key, const TranscriptionResult &result, idx_t capacity);
+
+	// Account for a persisted result and trim the directory once it exceeds whisper_cache_disk_mb
+	void PersistWritten(const WhisperConfig &config, int64_t bytes);
+
+	std::mutex mutex_;
+	std::list<Entry> lru_; // Most recently used first
+	std::unordered_map<std::string, std::list<Entry>::iterator> entries_;
+	idx_t capacity_ = WhisperConfig::DEFAULT_CACHE_SIZE;
+	int64_t hits_ = 0;
+	int64_t misses_ = 0;
+	int64_t disk_hits_ = 0;
+	std::unordered_map<std::string, int64_t> disk_bytes_; // Bytes persisted per cache directory
+	std::mutex trim_mutex_;
+};
+
+} // namespace duckdb
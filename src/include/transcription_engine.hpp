@@ -1,12 +1,21 @@
 #pragma once
 
 #include "duckdb.hpp"
+#include "audio_utils.hpp"
 #include "whisper_config.hpp"
 #include <string>
 #include <vector>
 
 namespace duckdb {
 
+// A text token of a segment (special tokens are left out)
+struct TranscriptionToken {
+	std::string text;   // May hold a partial UTF-8 sequence that the next token completes
+	double start_time;  // in seconds (only set with config.token_timestamps)
+	double end_time;    // in seconds (only set with config.token_timestamps)
+	double probability; // 0.0-1.0
+};
+
 struct TranscriptionSegment {
 	int segment_id;
 	double start_time; // in seconds
@@ -14,6 +23,23 @@ struct TranscriptionSegment {
 	std::string text;
 	double confidence; // 0.0-1.0
 	std::string language;
+	std::vector<TranscriptionToken> tokens; // Only filled with config.collect_tokens
+};
+
+// Where the time of one transcription went, for whisper_last_profile() and whisper_stats()
+// Stage times of chunked or packed runs are summed over the whisper runs involved.
+struct TranscriptionProfile {
+	bool cache_hit = false;
+	int threads = 0;              // ggml threads of the whisper run (the largest one for chunked runs)
+	int threads_in_use = 0;       // ggml threads held by all concurrent runs when this one started
+	double audio_seconds = 0.0;   // Length of the transcribed audio
+	double audio_decode_ms = 0.0; // Decoding and resampling to 16kHz mono
+	double model_load_ms = 0.0;   // Getting the model (includes the load on first use)
+	double mel_ms = 0.0;          // Spectrogram (and language detection with language=auto)
+	double encode_ms = 0.0;       // Encoder, until the first token of each window is sampled
+	double decode_ms = 0.0;       // Token decoding
+	double inference_ms = 0.0;    // Whole whisper run (mel + encode + decode)
+	double total_ms = 0.0;        // End to end
 };
 
 struct TranscriptionResult {
@@ -22,6 +48,24 @@ struct TranscriptionResult {
 	std::string detected_language;
 	bool success;
 	std::string error;
+	TranscriptionProfile profile;
+};
+
+// A single audio input for batch transcription (file path or in-memory BLOB)
+struct TranscriptionInput {
+	bool is_blob = false;
+	std::string file_path;
+	const uint8_t *data = nullptr; // Not owned, must outlive the batch
+	size_t size = 0;
+	std::string model; // Model override (empty = use config.model)
+};
+
+// Spoken language of an input, detected without transcribing it
+struct LanguageDetection {
+	std::string language;
+	double probability = 0.0; // 0.0-1.0
+	bool success = false;
+	std::string error;
 };
 
 class TranscriptionEngine {
@@ -34,6 +78,61 @@ public:
 
 	// Transcribe from already-loaded PCM data
 	static TranscriptionResult TranscribePCM(const std::vector<float> &pcm_data, const WhisperConfig &config);
+	static TranscriptionResult TranscribePCM(const float *samples, size_t n_samples, const WhisperConfig &config);
+
+	// Transcribe PCM data without adding a call to whisper_stats()
+	// For callers that transcribe the same audio several times and record a single call themselves.
+	static TranscriptionResult TranscribePass(const float *samples, size_t n_samples, const WhisperConfig &config);
+
+	// Check that config can transcribe at all (the model loads and supports the requested task)
+	// Returns false and sets error for failures that are not specific to any input.
+	static bool CheckConfig(const WhisperConfig &config, std::string &error);
+
+	// Transcribe many inputs concurrently (decode and inference run as separate pipeline stages)
+	// Results are returned in input order; failures are reported per result. With stop_on_error, no new input is
+	// started after the first failure, and the inputs that were never started are left with an empty error.
+	static std::vector<TranscriptionResult> TranscribeBatch(const std::vector<TranscriptionInput> &inputs,
+	                                                        const WhisperConfig &config, bool stop_on_error = false);
+
+	// Detect the language of each input from its first `seconds` of audio (at most one 30s window)
+	// Only the mel spectrogram and the encoder run, no decoding passes. Results are returned in input order.
+	static std::vector<LanguageDetection> DetectLanguageBatch(const std::vector<TranscriptionInput> &inputs,
+	                                                          double seconds, const WhisperConfig &config);
+};
+
+// Transcribes long recordings window by window while decoding
+// Peak memory is bounded by the window size and segments are available as soon as each window finishes.
+class StreamingTranscriber {
+public:
+	explicit StreamingTranscriber(const WhisperConfig &config);
+
+	bool OpenFile(const std::string &file_path, std::string &error);
+	bool OpenMemory(const uint8_t *data, size_t size, std::string &error);
+
+	// Decode and transcribe the next window, appending its segments (timestamps relative to the whole input)
+	// Returns false when the input is exhausted or on error (error is set in that case)
+	bool Next(std::vector<TranscriptionSegment> &segments, std::string &error);
+
+	// Profile of the window transcribed by the last successful Next()
+	const TranscriptionProfile &Profile() const {
+		return profile_;
+	}
+
+private:
+	// Pick a low-energy cut point near the end of the window so words are not split
+	size_t FindCutPoint() const;
+	// Start at config.range_start and stop at config.range_end
+	void SeekToRange();
+	// Whether all audio in the range has been read into the window
+	bool InputDone() const;
+
+	WhisperConfig config_;
+	AudioStreamReader reader_;
+	std::vector<float> window_;
+	size_t window_start_; // Sample offset of window_[0] in the input
+	size_t end_sample_;   // Sample offset where the range ends
+	int next_segment_id_;
+	TranscriptionProfile profile_;
 };
 
 } // namespace duckdb
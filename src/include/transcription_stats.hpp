@@ -0,0 +1,56 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "transcription_engine.hpp"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Cumulative counters for one model, for whisper_stats()
+struct ModelStats {
+	std::string model;
+	int64_t calls = 0;            // Transcriptions, including cache hits
+	int64_t cache_hits = 0;       // Calls served from the transcription cache
+	int64_t context_loads = 0;    // Times the model was loaded into memory
+	double audio_seconds = 0.0;   // Audio actually transcribed (cache hits excluded)
+	double audio_decode_ms = 0.0; // Summed over calls
+	double inference_ms = 0.0;    // Summed over calls
+	double model_load_ms = 0.0;   // Summed over loads
+};
+
+// Transcription counters per model (singleton, shared by all connections)
+// The most recent profile is kept per connection in a LastProfileContextState instead.
+class TranscriptionStats {
+public:
+	static TranscriptionStats &GetInstance();
+
+	// Record a finished transcription call
+	void RecordCall(const std::string &model, const TranscriptionProfile &profile);
+
+	// Record a model being loaded into memory
+	void RecordModelLoad(const std::string &model, double load_ms);
+
+	// Counters of every model used so far, ordered by model name
+	std::vector<ModelStats> GetModelStats();
+
+	// Remember a finished transcription as the most recent one of this connection
+	static void SetLastProfile(ClientContext &context, const std::string &model, const TranscriptionProfile &profile);
+
+	// Profile of the most recent call of this connection; returns false if it transcribed nothing yet
+	static bool GetLastProfile(ClientContext &context, std::string &model, TranscriptionProfile &profile);
+
+private:
+	TranscriptionStats() = default;
+	~TranscriptionStats() = default;
+
+	ModelStats &Entry(const std::string &model);
+
+	std::mutex mutex_;
+	std::map<std::string, ModelStats> models_;
+};
+
+} // namespace duckdb
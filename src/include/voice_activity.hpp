@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace duckdb {
+
+// A region of speech in 16kHz mono PCM, as sample offsets [start, end)
+struct SpeechSpan {
+	size_t start;
+	size_t end;
+};
+
+// Energy-based voice activity detection (frame RMS against a threshold, like AudioRecorder's silence detection)
+class VoiceActivityDetector {
+public:
+	// Find speech spans; short pauses are bridged and spans are padded so word edges are kept
+	static std::vector<SpeechSpan> DetectSpeech(const float *samples, size_t n_samples, float threshold);
+
+private:
+	static constexpr size_t SAMPLE_RATE = 16000;
+	static constexpr size_t FRAME_SAMPLES = SAMPLE_RATE * 30 / 1000;   // 30ms analysis frames
+	static constexpr size_t PADDING_SAMPLES = SAMPLE_RATE * 200 / 1000; // Kept around each span
+	static constexpr size_t MIN_SILENCE_SAMPLES = SAMPLE_RATE / 2;      // Shorter pauses are not cut
+	static constexpr size_t MIN_SPEECH_SAMPLES = SAMPLE_RATE / 10;      // Shorter bursts are treated as noise
+};
+
+} // namespace duckdb
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Native reader for WAV files that are already in whisper's input format (16kHz mono PCM)
+// Such files are converted straight to float32 without going through FFmpeg.
+class WavReader {
+public:
+	// Memory-map a file and decode it if eligible; returns false to request the FFmpeg path
+	static bool LoadFile(const std::string &file_path, std::vector<float> &output);
+
+	// Decode an in-memory WAV if eligible; returns false to request the FFmpeg path
+	static bool LoadMemory(const uint8_t *data, size_t size, std::vector<float> &output);
+
+	// Convert little-endian int16 samples to float32 in [-1, 1) (SIMD where available)
+	static void ConvertInt16(const uint8_t *input, size_t n_samples, float *output);
+};
+
+} // namespace duckdb
@@ -13,10 +13,39 @@ struct WhisperConfig {
 	std::string language;   // Language code or "auto"
 
 	// Processing settings
-	int threads;            // Number of threads to use
-	bool timestamps;        // Include timestamps in output
-	int max_segment_length; // Maximum segment length in milliseconds
-	bool translate;         // Translate to English instead of transcribe
+	int threads;                // Number of threads to use
+	std::string threads_policy; // How ggml threads are shared by concurrent transcriptions
+	int scheduler_threads;      // DuckDB's thread count (the budget for the auto and shared policies)
+	bool timestamps;            // Include timestamps in output
+	int max_segment_length;     // Maximum segment length in milliseconds
+	bool translate;             // Translate to English instead of transcribe
+	int max_concurrent_states;  // Maximum decoder states (parallel transcriptions) per loaded model
+	int model_cache_mb;         // Memory budget for loaded models in MB (0 = unlimited)
+	bool streaming;             // Decode and transcribe long files window by window
+	double stream_window;       // Streaming window length in seconds
+	int parallel_chunks;        // Split long audio into this many chunks transcribed concurrently
+	bool pack_clips;            // Pack short clips of a batch into shared 30 second windows
+	bool cache;                 // Reuse results for audio that was already transcribed
+	int cache_size;             // Maximum cached transcriptions held in memory
+	bool cache_persist;         // Also persist cached results under model_path
+	int cache_disk_mb;          // Size limit of the persisted results in MB (0 = unlimited)
+	std::string input_format;   // Container format hint (e.g. "wav") that skips probing
+	bool vad;                   // Skip non-speech regions before inference
+	double vad_threshold;       // RMS amplitude above which a frame counts as speech
+	int beam_size;              // Beam search width (1 = greedy decoding)
+	int best_of;                // Candidates sampled per window when sampling with temperature
+	double temperature;         // Initial sampling temperature
+	double temperature_inc;     // Temperature step for fallback decodes (0 = no fallback)
+	double entropy_thold;       // Entropy above which a decode is retried at a higher temperature
+	bool no_context;            // Do not condition each window on the previous window's text
+	int audio_ctx;              // Encoder context size (0 = full 1500 frames, smaller is faster for short clips)
+	bool flash_attn;            // Use flash attention kernels (model load option)
+	bool collect_tokens;        // Keep each segment's tokens and probabilities (set by whisper_transcribe_words)
+	bool token_timestamps;      // Also compute token start and end times (set by whisper_transcribe_words)
+	bool segment_confidence;    // Compute segment confidences (skipped when a query does not select them)
+	double range_start;         // Only transcribe the input from this time on, in seconds
+	double range_end;           // ... and up to this time (< 0 = to the end)
+	int concurrent_runs;        // Whisper runs the caller starts together (the auto thread policy splits them up front)
 
 	// Recording settings
 	int device_id;            // Audio input device ID (-1 = default)
@@ -27,8 +56,10 @@ struct WhisperConfig {
 	// Voice query settings
 	std::string text_to_sql_url; // URL of text-to-sql proxy
 	int text_to_sql_timeout;     // Timeout in seconds for proxy requests
+	bool text_to_sql_compress;   // Gzip-compress proxy request bodies
 	bool voice_query_show_sql;   // Show generated SQL in output
 	int voice_query_timeout;     // Timeout in seconds for entire voice query operation
+	int voice_query_max_tables;  // Tables sent to the proxy, best matches first (0 = all)
 
 	// Verbose mode
 	bool verbose; // Enable verbose status messages
@@ -37,26 +68,52 @@ struct WhisperConfig {
 	bool ffmpeg_logging; // Enable FFmpeg log output
 
 	// GPU acceleration
-	bool use_gpu; // Use GPU acceleration if available (Metal on macOS)
+	bool use_gpu;   // Use GPU acceleration if available (Metal, CUDA or Vulkan)
+	int gpu_device; // GPU to run on (-1 = spread transcriptions across all GPUs)
 
 	// Default values
 	static constexpr const char *DEFAULT_MODEL = "base.en";
 	static constexpr const char *DEFAULT_LANGUAGE = "auto";
 	static constexpr int DEFAULT_THREADS = 0; // 0 = auto-detect
+	static constexpr const char *DEFAULT_THREADS_POLICY = "auto"; // auto, per_call or shared
 	static constexpr bool DEFAULT_TIMESTAMPS = true;
 	static constexpr int DEFAULT_MAX_SEGMENT_LENGTH = 30000; // 30 seconds
 	static constexpr bool DEFAULT_TRANSLATE = false;
+	static constexpr int DEFAULT_MAX_CONCURRENT_STATES = 4;
+	static constexpr int DEFAULT_MODEL_CACHE_MB = 0;
+	static constexpr bool DEFAULT_STREAMING = false;
+	static constexpr double DEFAULT_STREAM_WINDOW = 30.0; // whisper's native window
+	static constexpr int DEFAULT_PARALLEL_CHUNKS = 1;     // 1 = sequential
+	static constexpr bool DEFAULT_PACK_CLIPS = false;
+	static constexpr bool DEFAULT_CACHE = false;
+	static constexpr int DEFAULT_CACHE_SIZE = 256;
+	static constexpr bool DEFAULT_CACHE_PERSIST = false;
+	static constexpr int DEFAULT_CACHE_DISK_MB = 1024;
+	static constexpr const char *DEFAULT_INPUT_FORMAT = ""; // Empty = probe the input
+	static constexpr bool DEFAULT_VAD = false;
+	static constexpr double DEFAULT_VAD_THRESHOLD = 0.01;
+	static constexpr int DEFAULT_BEAM_SIZE = 1;
+	static constexpr int DEFAULT_BEST_OF = 5;
+	static constexpr double DEFAULT_TEMPERATURE = 0.0;
+	static constexpr double DEFAULT_TEMPERATURE_INC = 0.2;
+	static constexpr double DEFAULT_ENTROPY_THOLD = 2.4;
+	static constexpr bool DEFAULT_NO_CONTEXT = true;
+	static constexpr int DEFAULT_AUDIO_CTX = 0;
+	static constexpr bool DEFAULT_FLASH_ATTN = true;           // whisper.cpp's default
 	static constexpr int DEFAULT_DEVICE_ID = -1;               // -1 = default device
 	static constexpr double DEFAULT_MAX_DURATION = 15.0;       // 15 seconds
 	static constexpr double DEFAULT_SILENCE_DURATION = 1.0;    // 1 second
 	static constexpr double DEFAULT_SILENCE_THRESHOLD = 0.001; // Very sensitive
 	static constexpr const char *DEFAULT_TEXT_TO_SQL_URL = "http://localhost:4000/generate-sql";
 	static constexpr int DEFAULT_TEXT_TO_SQL_TIMEOUT = 15;
+	static constexpr bool DEFAULT_TEXT_TO_SQL_COMPRESS = false;
 	static constexpr bool DEFAULT_VOICE_QUERY_SHOW_SQL = false;
 	static constexpr int DEFAULT_VOICE_QUERY_TIMEOUT = 30;
+	static constexpr int DEFAULT_VOICE_QUERY_MAX_TABLES = 0;
 	static constexpr bool DEFAULT_VERBOSE = false;
 	static constexpr bool DEFAULT_FFMPEG_LOGGING = false;
 	static constexpr bool DEFAULT_USE_GPU = true;
+	static constexpr int DEFAULT_GPU_DEVICE = -1; // -1 = all GPUs
 
 	WhisperConfig();
 
@@ -5,24 +5,24 @@
 #include <string>
 #include <memory>
 #include <mutex>
+#include <condition_variable>
 #include <unordered_map>
+#include <vector>
 
 namespace duckdb {
 
 // RAII wrapper for whisper_context
+// The context only holds the model weights; decoder states are pooled so that
+// several transcriptions can share one copy of the model.
 class WhisperContextWrapper {
 public:
-	WhisperContextWrapper(whisper_context *ctx);
+	WhisperContextWrapper(whisper_context *ctx, bool owns_context);
 	~WhisperContextWrapper();
 
-	// Non-copyable
+	// Non-copyable, non-movable (owns the state pool)
 	WhisperContextWrapper(const WhisperContextWrapper &) = delete;
 	WhisperContextWrapper &operator=(const WhisperContextWrapper &) = delete;
 
-	// Movable
-	WhisperContextWrapper(WhisperContextWrapper &&other) noexcept;
-	WhisperContextWrapper &operator=(WhisperContextWrapper &&other) noexcept;
-
 	whisper_context *Get() const {
 		return ctx_;
 	}
@@ -30,19 +30,90 @@ public:
 		return ctx_ != nullptr;
 	}
 
+	// Check out a decoder state, blocking while max_states states are in use
+	whisper_state *AcquireState(idx_t max_states, std::string &error);
+
+	// Return a decoder state to the pool
+	void ReleaseState(whisper_state *state);
+
+	// Number of decoder states created so far (idle or leased)
+	idx_t StateCount();
+
 private:
 	whisper_context *ctx_;
+	bool owns_context_; // Free the model and states on destruction (false for Metal, see destructor)
+
+	// Decoder state pool
+	std::mutex state_mutex_;
+	std::condition_variable state_cv_;
+	std::vector<whisper_state *> idle_states_;
+	idx_t total_states_;
+};
+
+// RAII lease on a pooled decoder state
+class WhisperStateLease {
+public:
+	WhisperStateLease(std::shared_ptr<WhisperContextWrapper> ctx, idx_t max_states, std::string &error);
+	~WhisperStateLease();
+
+	WhisperStateLease(const WhisperStateLease &) = delete;
+	WhisperStateLease &operator=(const WhisperStateLease &) = delete;
+
+	whisper_context *Context() const {
+		return ctx_->Get();
+	}
+	whisper_state *Get() const {
+		return state_;
+	}
+	bool IsValid() const {
+		return state_ != nullptr;
+	}
+
+private:
+	std::shared_ptr<WhisperContextWrapper> ctx_;
+	whisper_state *state_;
+};
+
+// Snapshot of a cached model, for whisper_loaded_models()
+struct LoadedModelInfo {
+	std::string model_path;
+	bool use_gpu;
+	int gpu_device; // Device the model is loaded on (-1 for CPU contexts)
+	bool flash_attn;
+	int64_t memory_bytes; // Model weights (approximated by the model file size)
+	idx_t decoder_states; // Decoder states allocated in the pool
+	bool in_use;          // Referenced by a running transcription
 };
 
 // Cached context manager (singleton pattern per database)
+// Models are kept loaded across queries. With a memory budget, the least recently used models
+// that are not in use are unloaded to make room for a new one.
 class WhisperContextManager {
 public:
 	static WhisperContextManager &GetInstance();
 
-	// Get or create a context for the given model
-	std::shared_ptr<WhisperContextWrapper> GetContext(const std::string &model_path, bool use_gpu, std::string &error);
+	// Get or create a context for the given model and load options (budget_mb = 0 means unlimited)
+	// With gpu_device < 0 the model runs on the GPU with the fewest running transcriptions of it, so concurrent
+	// transcriptions spread across all GPUs with one context (and state pool) per device.
+	// loaded, if given, is set to whether this call had to load the model. Concurrent calls for the same model wait
+	// for a single load, while models that are already loaded keep being served during it.
+	std::shared_ptr<WhisperContextWrapper> GetContext(const std::string &model_path, bool use_gpu, int gpu_device,
+	                                                  bool flash_attn, idx_t budget_mb, std::string &error,
+	                                                  bool *loaded = nullptr);
+
+	// Whether a model is currently loaded with the given load options (on any GPU for gpu_device < 0)
+	bool IsLoaded(const std::string &model_path, bool use_gpu, int gpu_device, bool flash_attn);
+
+	// Number of GPUs the compiled-in ggml backends can use (0 for CPU-only builds)
+	static int GpuDeviceCount();
 
-	// Clear cached context for a model
+	// Number of devices transcriptions with these options are spread across
+	static idx_t ScheduledDeviceCount(bool use_gpu, int gpu_device);
+
+	// List loaded models, most recently used first
+	std::vector<LoadedModelInfo> ListContexts();
+
+	// Clear cached contexts for a model (all load option variants)
 	void ClearContext(const std::string &model_path);
 
 	// Clear all cached contexts
@@ -52,8 +123,29 @@ private:
 	WhisperContextManager() = default;
 	~WhisperContextManager() = default;
 
+	struct CachedContext {
+		std::shared_ptr<WhisperContextWrapper> context;
+		std::string model_path;
+		bool use_gpu;
+		int gpu_device;
+		bool flash_attn;
+		int64_t memory_bytes;
+		uint64_t last_used; // Value of use_counter_ at the last lookup
+	};
+
+	// The GPU with the fewest running transcriptions of a model; caller holds mutex_
+	int PickDevice(const std::string &model_path, bool flash_attn);
+
+	// Unload idle models, least recently used first, until incoming_bytes fits; caller holds mutex_
+	void EvictForBudget(int64_t incoming_bytes, int64_t budget_bytes);
+
 	std::mutex mutex_;
-	std::unordered_map<std::string, std::shared_ptr<WhisperContextWrapper>> contexts_;
+	std::unordered_map<std::string, CachedContext> contexts_;
+	uint64_t use_counter_ = 0;
+
+	// Models being loaded (cache key -> estimated bytes); loads run without mutex_ so other models stay available
+	std::unordered_map<std::string, int64_t> loading_;
+	std::condition_variable loading_cv_; // Signalled whenever a load finishes
 };
 
 } // namespace duckdb
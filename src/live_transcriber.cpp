@@ -0,0 +1,163 @@
+#ifdef WHISPER_ENABLE_RECORDING
+
+#include "live_transcriber.hpp"
+#include "transcription_stats.hpp"
+
+namespace duckdb {
+
+static constexpr size_t LIVE_SAMPLE_RATE = 16000;
+static constexpr double SETTLE_SECONDS = 1.0;      // Segments ending this close to the live edge may still change
+static constexpr double MIN_PENDING_SECONDS = 1.0; // Less audio is not worth a whisper run until recording stops
+
+LiveTranscriber::LiveTranscriber(const WhisperConfig &config, double step_seconds)
+    : config_(config), step_seconds_(MaxValue<double>(step_seconds, 0.5)), max_seconds_(0.0), pending_start_(0),
+      next_segment_id_(0), recording_(false), finished_(false) {
+}
+
+bool LiveTranscriber::Start(int device_id, double max_seconds, double silence_seconds, std::string &error) {
+	if (!recorder_.StartRecording(device_id, error)) {
+		return false;
+	}
+	if (silence_seconds > 0.0) {
+		recorder_.SetSilenceStop(static_cast<float>(config_.silence_threshold), silence_seconds);
+	}
+	max_seconds_ = max_seconds;
+	start_time_ = std::chrono::steady_clock::now();
+	recording_ = true;
+	return true;
+}
+
+bool LiveTranscriber::Next(std::vector<LiveSegment> &segments, bool partials, std::string &error) {
+	if (finished_) {
+		return false;
+	}
+
+	if (recording_) {
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time_).count();
+		double wait = MinValue<double>(step_seconds_, max_seconds_ - elapsed);
+		bool stop = wait <= 0.0 || recorder_.Capture(wait) || elapsed + wait >= max_seconds_;
+		if (stop) {
+			recorder_.Stop();
+			recording_ = false;
+		}
+		recorder_.TakeCaptured(pending_);
+
+		// Only happens when the drain thread could not run for seconds; the text would silently skip speech
+		size_t dropped = recorder_.DroppedSamples();
+		if (dropped > 0) {
+			error = "Dropped " + std::to_string(static_cast<double>(dropped) / LIVE_SAMPLE_RATE) +
+			        " seconds of microphone audio because the recorder fell behind";
+			Finish();
+			return false;
+		}
+	}
+
+	if (!TranscribePending(!recording_, segments, partials, error)) {
+		Finish();
+		return false;
+	}
+	if (!recording_ && pending_.empty()) {
+		Finish();
+	}
+	return true;
+}
+
+void LiveTranscriber::Finish() {
+	if (finished_) {
+		return;
+	}
+	if (recording_) {
+		recorder_.Stop();
+		recording_ = false;
+	}
+	finished_ = true;
+	profile_.audio_seconds = recorder_.GetRecordingDuration();
+	TranscriptionStats::GetInstance().RecordCall(config_.model, profile_);
+}
+
+bool LiveTranscriber::TranscribePending(bool flush, std::vector<LiveSegment> &segments, bool partials,
+                                        std::string &error) {
+	double pending_seconds = static_cast<double>(pending_.size()) / static_cast<double>(LIVE_SAMPLE_RATE);
+	if (pending_.empty() || (!flush && pending_seconds < MIN_PENDING_SECONDS)) {
+		if (flush) {
+			pending_.clear();
+		}
+		return true;
+	}
+
+	auto result = TranscriptionEngine::TranscribePass(pending_.data(), pending_.size(), config_);
+	profile_.threads = MaxValue<int>(profile_.threads, result.profile.threads);
+	profile_.threads_in_use = MaxValue<int>(profile_.threads_in_use, result.profile.threads_in_use);
+	profile_.model_load_ms += result.profile.model_load_ms;
+	profile_.mel_ms += result.profile.mel_ms;
+	profile_.encode_ms += result.profile.encode_ms;
+	profile_.decode_ms += result.profile.decode_ms;
+	profile_.inference_ms += result.profile.inference_ms;
+	profile_.total_ms += result.profile.total_ms;
+	if (!result.success) {
+		error = result.error;
+		return false;
+	}
+
+	// Past a full window nothing gets more stable by waiting, so settle everything
+	bool settle_all = flush || pending_seconds >= MaxValue<double>(config_.stream_window, 1.0);
+	double offset = static_cast<double>(pending_start_) / static_cast<double>(LIVE_SAMPLE_RATE);
+	double settled_until = 0.0;
+	bool settling = true;
+	int partial_id = next_segment_id_;
+	for (auto &segment : result.segments) {
+		settling = settling && (settle_all || segment.end_time <= pending_seconds - SETTLE_SECONDS);
+		if (!settling && !partials) {
+			break;
+		}
+
+		LiveSegment live {segment, settling};
+		live.segment.start_time += offset;
+		live.segment.end_time += offset;
+		if (settling) {
+			live.segment.segment_id = next_segment_id_++;
+			settled_until = segment.end_time;
+			partial_id = next_segment_id_;
+		} else {
+			live.segment.segment_id = partial_id++;
+		}
+		segments.push_back(std::move(live));
+	}
+
+	// Drop the audio of settled segments; with no speech at all, keep only the live edge
+	size_t settled_samples;
+	if (settle_all) {
+		settled_samples = pending_.size();
+	} else if (result.segments.empty()) {
+		double silent_seconds = MaxValue<double>(pending_seconds - SETTLE_SECONDS, 0.0);
+		settled_samples = static_cast<size_t>(silent_seconds * LIVE_SAMPLE_RATE);
+	} else {
+		settled_samples = static_cast<size_t>(settled_until * LIVE_SAMPLE_RATE);
+	}
+	settled_samples = MinValue<size_t>(settled_samples, pending_.size());
+	pending_.erase(pending_.begin(), pending_.begin() + static_cast<ptrdiff_t>(settled_samples));
+	pending_start_ += settled_samples;
+	return true;
+}
+
+bool LiveTranscriber::TranscribeUntilStopped(std::string &text, std::string &error) {
+	std::vector<LiveSegment> segments;
+	while (Next(segments, false, error)) {
+	}
+	if (!error.empty()) {
+		return false;
+	}
+
+	text.clear();
+	for (auto &live : segments) {
+		if (!text.empty() && !live.segment.text.empty()) {
+			text += " ";
+		}
+		text += live.segment.text;
+	}
+	return true;
+}
+
+} // namespace duckdb
+
+#endif // WHISPER_ENABLE_RECORDING
@@ -0,0 +1,74 @@
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace duckdb {
+
+MappedFile::MappedFile(const std::string &file_path) {
+#ifdef _WIN32
+	HANDLE file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+	                          FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	file_ = file;
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file_, &file_size) || file_size.QuadPart == 0) {
+		return;
+	}
+	mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping_) {
+		return;
+	}
+	void *view = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+	if (view) {
+		data_ = static_cast<const uint8_t *>(view);
+		size_ = static_cast<size_t>(file_size.QuadPart);
+	}
+#else
+	int fd = open(file_path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+	struct stat buffer;
+	if (fstat(fd, &buffer) == 0 && S_ISREG(buffer.st_mode) && buffer.st_size > 0) {
+		void *view = mmap(nullptr, static_cast<size_t>(buffer.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (view != MAP_FAILED) {
+			data_ = static_cast<const uint8_t *>(view);
+			size_ = static_cast<size_t>(buffer.st_size);
+#ifdef POSIX_MADV_SEQUENTIAL
+			posix_madvise(view, size_, POSIX_MADV_SEQUENTIAL);
+#endif
+		}
+	}
+	// The mapping stays valid after the descriptor is closed
+	close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+	if (data_) {
+		UnmapViewOfFile(data_);
+	}
+	if (mapping_) {
+		CloseHandle(mapping_);
+	}
+	if (file_) {
+		CloseHandle(file_);
+	}
+#else
+	if (data_) {
+		munmap(const_cast<uint8_t *>(data_), size_);
+	}
+#endif
+}
+
+} // namespace duckdb
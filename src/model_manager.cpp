@@ -4,6 +4,14 @@
 #include <fstream>
 #include <sys/stat.h>
 
+#ifdef WHISPER_ENABLE_MODEL_DOWNLOAD
+#include "sha256.hpp"
+#include <cctype>
+#include <cstdio>
+#include <curl/curl.h>
+#include <mutex>
+#endif
+
 #ifdef _WIN32
 #include <direct.h>
 #define mkdir(path, mode) _mkdir(path)
@@ -11,28 +19,72 @@
 
 namespace duckdb {
 
-// Available Whisper models
-static const std::vector<std::string> AVAILABLE_MODELS = {"tiny",     "tiny.en",  "base",     "base.en",
-                                                          "small",    "small.en", "medium",   "medium.en",
-                                                          "large-v1", "large-v2", "large-v3", "large-v3-turbo"};
-
-// Model descriptions
-static const std::unordered_map<std::string, std::string> MODEL_DESCRIPTIONS = {
-    {"tiny", "Tiny multilingual model (~75MB, fastest)"},
-    {"tiny.en", "Tiny English-only model (~75MB, fastest)"},
-    {"base", "Base multilingual model (~142MB)"},
-    {"base.en", "Base English-only model (~142MB)"},
-    {"small", "Small multilingual model (~466MB)"},
-    {"small.en", "Small English-only model (~466MB)"},
-    {"medium", "Medium multilingual model (~1.5GB)"},
-    {"medium.en", "Medium English-only model (~1.5GB)"},
-    {"large-v1", "Large multilingual model v1 (~2.9GB, most accurate)"},
-    {"large-v2", "Large multilingual model v2 (~2.9GB, most accurate)"},
-    {"large-v3", "Large multilingual model v3 (~2.9GB, most accurate)"},
-    {"large-v3-turbo", "Large multilingual model v3 turbo (~1.6GB, fast + accurate)"}};
+static constexpr int64_t BYTES_PER_MB = 1024 * 1024;
+
+struct ModelCatalogEntry {
+	const char *name;
+	int64_t download_size; // Approximate size of the ggml file in bytes
+	const char *description;
+};
+
+// Available Whisper models (f16 originals, then quantized variants published alongside them)
+static const ModelCatalogEntry MODEL_CATALOG[] = {
+    {"tiny", 75 * BYTES_PER_MB, "Tiny multilingual model (~75MB, fastest)"},
+    {"tiny.en", 75 * BYTES_PER_MB, "Tiny English-only model (~75MB, fastest)"},
+    {"base", 142 * BYTES_PER_MB, "Base multilingual model (~142MB)"},
+    {"base.en", 142 * BYTES_PER_MB, "Base English-only model (~142MB)"},
+    {"small", 466 * BYTES_PER_MB, "Small multilingual model (~466MB)"},
+    {"small.en", 466 * BYTES_PER_MB, "Small English-only model (~466MB)"},
+    {"medium", 1500 * BYTES_PER_MB, "Medium multilingual model (~1.5GB)"},
+    {"medium.en", 1500 * BYTES_PER_MB, "Medium English-only model (~1.5GB)"},
+    {"large-v1", 2900 * BYTES_PER_MB, "Large multilingual model v1 (~2.9GB, most accurate)"},
+    {"large-v2", 2900 * BYTES_PER_MB, "Large multilingual model v2 (~2.9GB, most accurate)"},
+    {"large-v3", 2900 * BYTES_PER_MB, "Large multilingual model v3 (~2.9GB, most accurate)"},
+    {"large-v3-turbo", 1600 * BYTES_PER_MB, "Large multilingual model v3 turbo (~1.6GB, fast + accurate)"},
+    {"tiny-q5_1", 31 * BYTES_PER_MB, "Tiny multilingual model, 5-bit quantized (~31MB)"},
+    {"tiny.en-q5_1", 31 * BYTES_PER_MB, "Tiny English-only model, 5-bit quantized (~31MB)"},
+    {"tiny-q8_0", 42 * BYTES_PER_MB, "Tiny multilingual model, 8-bit quantized (~42MB)"},
+    {"base-q5_1", 57 * BYTES_PER_MB, "Base multilingual model, 5-bit quantized (~57MB)"},
+    {"base.en-q5_1", 57 * BYTES_PER_MB, "Base English-only model, 5-bit quantized (~57MB)"},
+    {"base-q8_0", 78 * BYTES_PER_MB, "Base multilingual model, 8-bit quantized (~78MB)"},
+    {"small-q5_1", 181 * BYTES_PER_MB, "Small multilingual model, 5-bit quantized (~181MB)"},
+    {"small.en-q5_1", 181 * BYTES_PER_MB, "Small English-only model, 5-bit quantized (~181MB)"},
+    {"small-q8_0", 252 * BYTES_PER_MB, "Small multilingual model, 8-bit quantized (~252MB)"},
+    {"medium-q5_0", 514 * BYTES_PER_MB, "Medium multilingual model, 5-bit quantized (~514MB)"},
+    {"medium.en-q5_0", 514 * BYTES_PER_MB, "Medium English-only model, 5-bit quantized (~514MB)"},
+    {"medium-q8_0", 785 * BYTES_PER_MB, "Medium multilingual model, 8-bit quantized (~785MB)"},
+    {"large-v2-q5_0", 1080 * BYTES_PER_MB, "Large multilingual model v2, 5-bit quantized (~1.1GB)"},
+    {"large-v2-q8_0", 1500 * BYTES_PER_MB, "Large multilingual model v2, 8-bit quantized (~1.5GB)"},
+    {"large-v3-q5_0", 1080 * BYTES_PER_MB, "Large multilingual model v3, 5-bit quantized (~1.1GB)"},
+    {"large-v3-turbo-q5_0", 547 * BYTES_PER_MB, "Large multilingual model v3 turbo, 5-bit quantized (~547MB)"},
+    {"large-v3-turbo-q8_0", 834 * BYTES_PER_MB, "Large multilingual model v3 turbo, 8-bit quantized (~834MB)"}};
+
+static const ModelCatalogEntry *FindCatalogEntry(const std::string &model_name) {
+	for (const auto &entry : MODEL_CATALOG) {
+		if (model_name == entry.name) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
 
 const std::vector<std::string> &ModelManager::GetAvailableModels() {
-	return AVAILABLE_MODELS;
+	static const std::vector<std::string> models = []() {
+		std::vector<std::string> names;
+		for (const auto &entry : MODEL_CATALOG) {
+			names.emplace_back(entry.name);
+		}
+		return names;
+	}();
+	return models;
+}
+
+std::string ModelManager::GetQuantization(const std::string &model_name) {
+	auto pos = model_name.rfind('-');
+	if (pos != std::string::npos && model_name.size() > pos + 1 && model_name[pos + 1] == 'q') {
+		return model_name.substr(pos + 1);
+	}
+	return "f16";
 }
 
 std::string ModelManager::GetModelUrl(const std::string &model_name) {
@@ -59,8 +111,10 @@ ModelInfo ModelManager::GetModelInfo(const std::string &model_name, const std::s
 	info.file_path = GetModelPath(model_name, base_path);
 	info.is_downloaded = IsModelDownloaded(model_name, base_path);
 
-	auto desc_it = MODEL_DESCRIPTIONS.find(model_name);
-	info.description = desc_it != MODEL_DESCRIPTIONS.end() ? desc_it->second : "";
+	auto entry = FindCatalogEntry(model_name);
+	info.description = entry ? entry->description : "";
+	info.download_size = entry ? entry->download_size : 0;
+	info.quantization = GetQuantization(model_name);
 
 	if (info.is_downloaded) {
 		struct stat buffer;
@@ -78,8 +132,8 @@ ModelInfo ModelManager::GetModelInfo(const std::string &model_name, const std::s
 
 std::vector<ModelInfo> ModelManager::ListModels(const std::string &base_path) {
 	std::vector<ModelInfo> models;
-	for (const auto &model_name : AVAILABLE_MODELS) {
-		models.push_back(GetModelInfo(model_name, base_path));
+	for (const auto &entry : MODEL_CATALOG) {
+		models.push_back(GetModelInfo(entry.name, base_path));
 	}
 	return models;
 }
@@ -107,6 +161,179 @@ static bool CreateDirectories(const std::string &path) {
 	return true;
 }
 
+#ifdef WHISPER_ENABLE_MODEL_DOWNLOAD
+
+struct DownloadState {
+	FILE *file = nullptr;
+	SHA256 hash;
+	int64_t resume_offset = 0;
+	long status_code = 0; // Status of the final (post-redirect) response
+	std::string expected_sha256;
+	std::string error;
+};
+
+static std::string ToLower(std::string value) {
+	for (auto &c : value) {
+		c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+	}
+	return value;
+}
+
+// Hugging Face publishes the SHA-256 of LFS files in X-Linked-ETag on the resolve redirect
+static size_t DownloadHeaderCallback(char *buffer, size_t size, size_t nitems, void *userdata) {
+	auto state = static_cast<DownloadState *>(userdata);
+	size_t total_size = size * nitems;
+	std::string line(buffer, total_size);
+
+	if (line.compare(0, 5, "HTTP/") == 0) {
+		auto space = line.find(' ');
+		state->status_code = space != std::string::npos ? strtol(line.c_str() + space + 1, nullptr, 10) : 0;
+		return total_size;
+	}
+
+	auto colon = line.find(':');
+	if (colon != std::string::npos && ToLower(line.substr(0, colon)) == "x-linked-etag") {
+		std::string value;
+		for (size_t i = colon + 1; i < line.size(); i++) {
+			if (isxdigit(static_cast<unsigned char>(line[i]))) {
+				value += static_cast<char>(tolower(static_cast<unsigned char>(line[i])));
+			}
+		}
+		if (value.size() == 64) {
+			state->expected_sha256 = value;
+		}
+	}
+	return total_size;
+}
+
+static size_t DownloadWriteCallback(void *contents, size_t size, size_t nmemb, void *userp) {
+	auto state = static_cast<DownloadState *>(userp);
+	size_t total_size = size * nmemb;
+	if (fwrite(contents, 1, total_size, state->file) != total_size) {
+		state->error = "Failed to write model file (disk full?)";
+		return 0;
+	}
+	state->hash.Update(static_cast<const uint8_t *>(contents), total_size);
+	return total_size;
+}
+
+// Hash the bytes already downloaded so a resumed download can still be verified end to end
+static bool HashExistingFile(FILE *file, SHA256 &hash, int64_t &size) {
+	std::vector<uint8_t> buffer(1024 * 1024);
+	size = 0;
+	size_t n;
+	while ((n = fread(buffer.data(), 1, buffer.size(), file)) > 0) {
+		hash.Update(buffer.data(), n);
+		size += static_cast<int64_t>(n);
+	}
+	return ferror(file) == 0;
+}
+
+// Run one transfer into state.file, resuming from state.resume_offset when it is non-zero
+static CURLcode PerformDownload(const std::string &url, DownloadState &state) {
+	CURL *curl = curl_easy_init();
+	if (!curl) {
+		state.error = "Failed to initialize HTTP client";
+		return CURLE_FAILED_INIT;
+	}
+
+	curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+	curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+	curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+	curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 30L);
+	// Abort stalled transfers (less than 1KB/s for a minute); a later call resumes where this one stopped
+	curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1024L);
+	curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, 60L);
+	curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, DownloadHeaderCallback);
+	curl_easy_setopt(curl, CURLOPT_HEADERDATA, &state);
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, DownloadWriteCallback);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &state);
+	if (state.resume_offset > 0) {
+		curl_easy_setopt(curl, CURLOPT_RESUME_FROM_LARGE, static_cast<curl_off_t>(state.resume_offset));
+	}
+
+	CURLcode res = curl_easy_perform(curl);
+	curl_easy_cleanup(curl);
+	return res;
+}
+
+bool ModelManager::DownloadFile(const std::string &url, const std::string &target_path, std::string &error) {
+	// Download into a .part file next to the target, then rename it into place once verified
+	std::string part_path = target_path + ".part";
+
+	DownloadState state;
+	state.file = fopen(part_path.c_str(), "a+b");
+	if (!state.file) {
+		error = "Failed to open " + part_path + " for writing";
+		return false;
+	}
+	fseek(state.file, 0, SEEK_SET);
+	if (!HashExistingFile(state.file, state.hash, state.resume_offset)) {
+		fclose(state.file);
+		error = "Failed to read partial download " + part_path;
+		return false;
+	}
+
+	CURLcode res = PerformDownload(url, state);
+	if (res == CURLE_RANGE_ERROR && state.resume_offset > 0) {
+		// The server ignored the range request and libcurl stopped before the body; start the file over
+		fclose(state.file);
+		state.file = fopen(part_path.c_str(), "wb");
+		if (!state.file) {
+			error = "Failed to truncate partial download " + part_path;
+			return false;
+		}
+		state.hash = SHA256();
+		state.resume_offset = 0;
+		state.status_code = 0;
+		res = PerformDownload(url, state);
+	}
+
+	bool closed = state.file && fclose(state.file) == 0;
+	state.file = nullptr;
+
+	// 416: the partial file already holds the whole model (or more); verify it as is
+	bool complete = res == CURLE_OK || (state.resume_offset > 0 && state.status_code == 416);
+	if (!complete) {
+		error = "Download failed: " + std::string(curl_easy_strerror(res));
+		if (!state.error.empty()) {
+			error += " (" + state.error + ")";
+		}
+		error += ". Run the download again to resume from " + part_path;
+		return false;
+	}
+	if (!closed) {
+		error = "Failed to write model file " + part_path;
+		return false;
+	}
+
+	// Never move an unverified file into place: without a published checksum the download stays a .part file
+	if (state.expected_sha256.empty()) {
+		error = "No SHA-256 checksum was published for " + url + "; refusing to install the unverified download " +
+		        part_path;
+		return false;
+	}
+	std::string actual_sha256 = state.hash.FinalizeHex();
+	if (actual_sha256 != state.expected_sha256) {
+		remove(part_path.c_str());
+		error = "Checksum mismatch for " + url + " (expected " + state.expected_sha256 + ", got " + actual_sha256 +
+		        "); the partial download was removed";
+		return false;
+	}
+
+#ifdef _WIN32
+	remove(target_path.c_str());
+#endif
+	if (rename(part_path.c_str(), target_path.c_str()) != 0) {
+		error = "Failed to move " + part_path + " to " + target_path;
+		return false;
+	}
+	return true;
+}
+
+#endif // WHISPER_ENABLE_MODEL_DOWNLOAD
+
 bool ModelManager::DownloadModel(const std::string &model_name, const std::string &base_path, std::string &error) {
 	if (!IsValidModelName(model_name)) {
 		error = "Invalid model name: " + model_name;
@@ -125,12 +352,18 @@ bool ModelManager::DownloadModel(const std::string &model_name, const std::strin
 		return true;
 	}
 
-	// For now, provide instructions for manual download
-	// Users can use: COPY (SELECT * FROM read_blob('url')) TO 'path'
-	// Or use curl/wget externally
 	std::string model_url = GetModelUrl(model_name);
 	std::string model_path = GetModelPath(model_name, base_path);
 
+#ifdef WHISPER_ENABLE_MODEL_DOWNLOAD
+	// One download per model at a time within this process
+	static std::mutex download_mutex;
+	std::lock_guard<std::mutex> lock(download_mutex);
+	if (IsModelDownloaded(model_name, base_path)) {
+		return true;
+	}
+	return DownloadFile(model_url, model_path, error);
+#else
 	error = "Please download the model manually:\n"
 	        "  curl -L -o '" +
 	        model_path + "' '" + model_url +
@@ -141,15 +374,11 @@ bool ModelManager::DownloadModel(const std::string &model_name, const std::strin
 	        model_url + "')) TO '" + model_path + "';";
 
 	return false;
+#endif
 }
 
 bool ModelManager::IsValidModelName(const std::string &model_name) {
-	for (const auto &valid_name : AVAILABLE_MODELS) {
-		if (valid_name == model_name) {
-			return true;
-		}
-	}
-	return false;
+	return FindCatalogEntry(model_name) != nullptr;
 }
 
 } // namespace duckdb
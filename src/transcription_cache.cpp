@@ -0,0 +1,352 @@
+#include "transcription_cache.hpp"
+#include "sha256.hpp"
+
+#include "duckdb/common/local_file_system.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sys/stat.h>
+#include <thread>
+
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+namespace duckdb {
+
+// Bumped whenever the on-disk layout changes so stale files are ignored
+static constexpr uint32_t CACHE_FILE_MAGIC = 0x33435457; // "WTC3"
+
+// Once over its size limit, the on-disk cache is trimmed to this share of it so trims stay rare
+static constexpr double DISK_TRIM_RATIO = 0.9;
+
+TranscriptionCache &TranscriptionCache::GetInstance() {
+	static TranscriptionCache instance;
+	return instance;
+}
+
+// Decode parameters that change the transcription output
+static std::string ParamsKey(const WhisperConfig &config) {
+	return "|model=" + config.model + "|language=" + config.language +
+	       "|translate=" + (config.translate ? "1" : "0") +
+	       "|max_segment_length=" + std::to_string(config.max_segment_length) +
+	       "|vad=" + (config.vad ? std::to_string(config.vad_threshold) : "off") +
+	       "|beam_size=" + std::to_string(config.beam_size) + "|best_of=" + std::to_string(config.best_of) +
+	       "|temperature=" + std::to_string(config.temperature) + "/" + std::to_string(config.temperature_inc) +
+	       "|entropy_thold=" + std::to_string(config.entropy_thold) + "|no_context=" + (config.no_context ? "1" : "0") +
+	       "|audio_ctx=" + std::to_string(config.audio_ctx) + "|chunks=" + std::to_string(config.parallel_chunks) +
+	       "|model_path=" + config.model_path + "|format=" + config.input_format +
+	       (config.flash_attn ? "|flash_attn" : "") +
+	       (config.pack_clips ? "|packed" : "") +
+	       (config.collect_tokens ? (config.token_timestamps ? "|tokens=timed" : "|tokens") : "") +
+	       (config.segment_confidence ? "" : "|no_confidence") +
+	       (config.range_start > 0.0 || config.range_end >= 0.0
+	            ? "|range=" + std::to_string(config.range_start) + "/" + std::to_string(config.range_end)
+	            : "");
+}
+
+// Modification time with the finest resolution the platform reports, so a rewrite within a second is noticed
+static std::string ModificationTime(const struct stat &buffer) {
+#if defined(__APPLE__)
+	return std::to_string(static_cast<int64_t>(buffer.st_mtimespec.tv_sec)) + "." +
+	       std::to_string(static_cast<int64_t>(buffer.st_mtimespec.tv_nsec));
+#elif defined(_WIN32)
+	return std::to_string(static_cast<int64_t>(buffer.st_mtime));
+#else
+	return std::to_string(static_cast<int64_t>(buffer.st_mtim.tv_sec)) + "." +
+	       std::to_string(static_cast<int64_t>(buffer.st_mtim.tv_nsec));
+#endif
+}
+
+bool TranscriptionCache::FileKey(const std::string &file_path, const WhisperConfig &config, std::string &key) {
+	struct stat buffer;
+	if (stat(file_path.c_str(), &buffer) != 0) {
+		return false;
+	}
+	key = "file:" + file_path + "|mtime=" + ModificationTime(buffer) +
+	      "|size=" + std::to_string(static_cast<int64_t>(buffer.st_size)) + ParamsKey(config);
+	return true;
+}
+
+std::string TranscriptionCache::MemoryKey(const uint8_t *data, size_t size, const WhisperConfig &config) {
+	// A collision would silently serve another recording's transcript (possibly from disk), so use SHA-256
+	SHA256 content_hash;
+	content_hash.Update(data, size);
+	return "blob:" + content_hash.FinalizeHex() + "|size=" + std::to_string(size) + ParamsKey(config);
+}
+
+// ============================================================================
+// On-disk persistence
+// ============================================================================
+
+static std::string CacheDirectory(const WhisperConfig &config) {
+	return config.model_path + "/transcripts";
+}
+
+static std::string CacheFilePath(const std::string &key, const WhisperConfig &config) {
+	SHA256 key_hash;
+	key_hash.Update(reinterpret_cast<const uint8_t *>(key.data()), key.size());
+	return CacheDirectory(config) + "/" + key_hash.FinalizeHex() + ".bin";
+}
+
+static void WriteString(std::ofstream &out, const std::string &value) {
+	uint32_t length = static_cast<uint32_t>(value.size());
+	out.write(reinterpret_cast<const char *>(&length), sizeof(length));
+	out.write(value.data(), length);
+}
+
+static bool ReadString(std::ifstream &in, std::string &value) {
+	uint32_t length;
+	if (!in.read(reinterpret_cast<char *>(&length), sizeof(length))) {
+		return false;
+	}
+	value.resize(length);
+	return length == 0 || static_cast<bool>(in.read(&value[0], length));
+}
+
+template <class T>
+static void WritePOD(std::ofstream &out, const T &value) {
+	out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+static bool ReadPOD(std::ifstream &in, T &value) {
+	return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+static bool LoadFromDisk(const std::string &key, const WhisperConfig &config, TranscriptionResult &result) {
+	std::ifstream in(CacheFilePath(key, config), std::ios::binary);
+	if (!in) {
+		return false;
+	}
+
+	uint32_t magic;
+	std::string stored_key;
+	if (!ReadPOD(in, magic) || magic != CACHE_FILE_MAGIC || !ReadString(in, stored_key) || stored_key != key) {
+		return false;
+	}
+
+	TranscriptionResult loaded;
+	uint32_t n_segments;
+	if (!ReadString(in, loaded.full_text) || !ReadString(in, loaded.detected_language) || !ReadPOD(in, n_segments)) {
+		return false;
+	}
+
+	loaded.segments.resize(n_segments);
+	for (auto &segment : loaded.segments) {
+		int32_t segment_id;
+		if (!ReadPOD(in, segment_id) || !ReadPOD(in, segment.start_time) || !ReadPOD(in, segment.end_time) ||
+		    !ReadString(in, segment.text) || !ReadPOD(in, segment.confidence) || !ReadString(in, segment.language)) {
+			return false;
+		}
+		segment.segment_id = segment_id;
+
+		uint32_t n_tokens;
+		if (!ReadPOD(in, n_tokens)) {
+			return false;
+		}
+		segment.tokens.resize(n_tokens);
+		for (auto &token : segment.tokens) {
+			if (!ReadString(in, token.text) || !ReadPOD(in, token.start_time) || !ReadPOD(in, token.end_time) ||
+			    !ReadPOD(in, token.probability)) {
+				return false;
+			}
+		}
+	}
+
+	loaded.success = true;
+	result = std::move(loaded);
+	return true;
+}
+
+// Write a result to disk; returns the size of the file written (0 on failure)
+static int64_t SaveToDisk(const std::string &key, const WhisperConfig &config, const TranscriptionResult &result) {
+	std::string dir = CacheDirectory(config);
+#ifdef _WIN32
+	_mkdir(dir.c_str());
+#else
+	mkdir(dir.c_str(), 0755);
+#endif
+
+	// Write to a temporary file and rename so concurrent readers never see a partial entry
+	std::string path = CacheFilePath(key, config);
+	std::string tmp_path = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+	{
+		std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			return 0;
+		}
+
+		WritePOD(out, CACHE_FILE_MAGIC);
+		WriteString(out, key);
+		WriteString(out, result.full_text);
+		WriteString(out, result.detected_language);
+		WritePOD(out, static_cast<uint32_t>(result.segments.size()));
+		for (auto &segment : result.segments) {
+			WritePOD(out, static_cast<int32_t>(segment.segment_id));
+			WritePOD(out, segment.start_time);
+			WritePOD(out, segment.end_time);
+			WriteString(out, segment.text);
+			WritePOD(out, segment.confidence);
+			WriteString(out, segment.language);
+			WritePOD(out, static_cast<uint32_t>(segment.tokens.size()));
+			for (auto &token : segment.tokens) {
+				WriteString(out, token.text);
+				WritePOD(out, token.start_time);
+				WritePOD(out, token.end_time);
+				WritePOD(out, token.probability);
+			}
+		}
+		if (!out) {
+			out.close();
+			std::remove(tmp_path.c_str());
+			return 0;
+		}
+	}
+	if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+		std::remove(tmp_path.c_str());
+		return 0;
+	}
+	struct stat buffer;
+	return stat(path.c_str(), &buffer) == 0 ? static_cast<int64_t>(buffer.st_size) : 0;
+}
+
+// Delete the oldest persisted results until the directory fits target_bytes; returns the bytes left
+static int64_t TrimDiskCache(const std::string &dir, int64_t target_bytes) {
+	struct CachedFile {
+		std::string path;
+		int64_t size;
+		int64_t mtime;
+	};
+	std::vector<CachedFile> files;
+	int64_t total_bytes = 0;
+	LocalFileSystem fs;
+	fs.ListFiles(dir, [&](const std::string &name, bool is_directory) {
+		if (is_directory || name.size() < 4 || name.compare(name.size() - 4, 4, ".bin") != 0) {
+			return;
+		}
+		std::string path = dir + "/" + name;
+		struct stat buffer;
+		if (stat(path.c_str(), &buffer) == 0) {
+			files.push_back({path, static_cast<int64_t>(buffer.st_size), static_cast<int64_t>(buffer.st_mtime)});
+			total_bytes += static_cast<int64_t>(buffer.st_size);
+		}
+	});
+
+	std::sort(files.begin(), files.end(), [](const CachedFile &a, const CachedFile &b) { return a.mtime < b.mtime; });
+	for (auto &file : files) {
+		if (total_bytes <= target_bytes) {
+			break;
+		}
+		if (std::remove(file.path.c_str()) == 0) {
+			total_bytes -= file.size;
+		}
+	}
+	return total_bytes;
+}
+
+// ============================================================================
+// In-memory LRU
+// ============================================================================
+
+void TranscriptionCache::Insert(const std::string &key, const TranscriptionResult &result, idx_t capacity) {
+	capacity_ = capacity;
+
+	auto it = entries_.find(key);
+	if (it != entries_.end()) {
+		it->second->second = result;
+		lru_.splice(lru_.begin(), lru_, it->second);
+	} else if (capacity_ > 0) {
+		lru_.emplace_front(key, result);
+		entries_[key] = lru_.begin();
+	}
+
+	while (lru_.size() > capacity_) {
+		entries_.erase(lru_.back().first);
+		lru_.pop_back();
+	}
+}
+
+bool TranscriptionCache::Lookup(const std::string &key, const WhisperConfig &config, TranscriptionResult &result) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = entries_.find(key);
+		if (it != entries_.end()) {
+			lru_.splice(lru_.begin(), lru_, it->second);
+			result = it->second->second;
+			hits_++;
+			return true;
+		}
+	}
+
+	// Disk reads happen outside the lock
+	if (config.cache_persist && LoadFromDisk(key, config, result)) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		Insert(key, result, static_cast<idx_t>(MaxValue<int>(config.cache_size, 0)));
+		hits_++;
+		disk_hits_++;
+		return true;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	misses_++;
+	return false;
+}
+
+void TranscriptionCache::Store(const std::string &key, const WhisperConfig &config, const TranscriptionResult &result) {
+	if (!result.success) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		Insert(key, result, static_cast<idx_t>(MaxValue<int>(config.cache_size, 0)));
+	}
+
+	if (config.cache_persist) {
+		int64_t written = SaveToDisk(key, config, result);
+		if (config.cache_disk_mb > 0 && written > 0) {
+			PersistWritten(config, written);
+		}
+	}
+}
+
+void TranscriptionCache::PersistWritten(const WhisperConfig &config, int64_t bytes) {
+	int64_t budget_bytes = static_cast<int64_t>(config.cache_disk_mb) * 1024 * 1024;
+	std::string dir = CacheDirectory(config);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		// The directory is measured on the first write (it may hold results of earlier sessions), then tracked
+		auto it = disk_bytes_.find(dir);
+		if (it != disk_bytes_.end()) {
+			it->second += bytes;
+			if (it->second <= budget_bytes) {
+				return;
+			}
+		}
+	}
+
+	// One trim at a time; writers that find one running skip theirs
+	std::unique_lock<std::mutex> trim_lock(trim_mutex_, std::try_to_lock);
+	if (!trim_lock.owns_lock()) {
+		return;
+	}
+	int64_t remaining = TrimDiskCache(dir, static_cast<int64_t>(static_cast<double>(budget_bytes) * DISK_TRIM_RATIO));
+	std::lock_guard<std::mutex> lock(mutex_);
+	disk_bytes_[dir] = remaining;
+}
+
+TranscriptionCacheStats TranscriptionCache::GetStats() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	TranscriptionCacheStats stats;
+	stats.hits = hits_;
+	stats.misses = misses_;
+	stats.disk_hits = disk_hits_;
+	stats.entries = static_cast<int64_t>(lru_.size());
+	stats.capacity = static_cast<int64_t>(capacity_);
+	return stats;
+}
+
+} // namespace duckdb
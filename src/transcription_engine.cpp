@@ -1,11 +1,23 @@
 #include "transcription_engine.hpp"
 #include "audio_utils.hpp"
 #include "model_manager.hpp"
+#include "transcription_cache.hpp"
+#include "transcription_stats.hpp"
+#include "voice_activity.hpp"
 #include "whisper_context.hpp"
 #include "whisper.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 
 namespace duckdb {
 
@@ -15,45 +27,555 @@ static std::string GetLanguageCode(int lang_id) {
 	return lang ? std::string(lang) : "unknown";
 }
 
-// Calculate confidence from token probabilities
-static double CalculateSegmentConfidence(whisper_context *ctx, int segment_idx) {
-	int n_tokens = whisper_full_n_tokens(ctx, segment_idx);
+// Calculate confidence from token probabilities, keeping the tokens when config.collect_tokens is set
+static void ReadSegmentTokens(whisper_context *ctx, whisper_state *state, int segment_idx, const WhisperConfig &config,
+                              TranscriptionSegment &segment) {
+	segment.confidence = 0.0;
+	int n_tokens = whisper_full_n_tokens_from_state(state, segment_idx);
 	if (n_tokens == 0)
-		return 0.0;
+		return;
 
 	double sum_prob = 0.0;
 	int count = 0;
 
 	for (int i = 0; i < n_tokens; i++) {
-		whisper_token_data token = whisper_full_get_token_data(ctx, segment_idx, i);
+		whisper_token_data token = whisper_full_get_token_data_from_state(state, segment_idx, i);
 		// Skip special tokens
-		if (token.id < whisper_token_eot(ctx)) {
-			sum_prob += token.p;
-			count++;
+		if (token.id >= whisper_token_eot(ctx)) {
+			continue;
+		}
+		sum_prob += token.p;
+		count++;
+
+		if (config.collect_tokens) {
+			TranscriptionToken token_info;
+			const char *text = whisper_full_get_token_text_from_state(ctx, state, segment_idx, i);
+			token_info.text = text ? text : "";
+			token_info.start_time = config.token_timestamps ? static_cast<double>(token.t0) / 100.0 : 0.0;
+			token_info.end_time = config.token_timestamps ? static_cast<double>(token.t1) / 100.0 : 0.0;
+			token_info.probability = token.p;
+			segment.tokens.push_back(std::move(token_info));
 		}
 	}
 
-	return count > 0 ? sum_prob / count : 0.0;
+	segment.confidence = count > 0 ? sum_prob / count : 0.0;
 }
 
-TranscriptionResult TranscriptionEngine::TranscribePCM(const std::vector<float> &pcm_data,
-                                                       const WhisperConfig &config) {
+// Apply a time mapping to a segment and its tokens; map(seconds, is_end) tells which edge it is given
+template <class MAP>
+static void MapSegmentTimes(TranscriptionSegment &segment, MAP &&map) {
+	segment.start_time = map(segment.start_time, false);
+	segment.end_time = MaxValue<double>(segment.start_time, map(segment.end_time, true));
+	for (auto &token : segment.tokens) {
+		token.start_time = map(token.start_time, false);
+		token.end_time = MaxValue<double>(token.start_time, map(token.end_time, true));
+	}
+}
+
+// ============================================================================
+// Profiling
+// ============================================================================
+
+using ProfileClock = std::chrono::steady_clock;
+
+static double ElapsedMs(ProfileClock::time_point from, ProfileClock::time_point to) {
+	return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+// Splits a whisper run into stages through its callbacks
+// The spectrogram is done when the first window starts encoding, and a window's encoder is done
+// when its first token is sampled (logits are processed on several threads, hence the atomic).
+struct InferenceTimer {
+	ProfileClock::time_point start;
+	ProfileClock::time_point encode_start;
+	bool started_encoding = false;
+	std::atomic<bool> encoding {false};
+	double mel_ms = 0.0;
+	double encode_ms = 0.0;
+
+	static bool OnEncoderBegin(whisper_context *, whisper_state *, void *user_data) {
+		auto &timer = *static_cast<InferenceTimer *>(user_data);
+		timer.encode_start = ProfileClock::now();
+		if (!timer.started_encoding) {
+			timer.mel_ms = ElapsedMs(timer.start, timer.encode_start);
+			timer.started_encoding = true;
+		}
+		timer.encoding.store(true);
+		return true;
+	}
+
+	static void OnLogitsFilter(whisper_context *, whisper_state *, const whisper_token_data *, int, float *,
+	                           void *user_data) {
+		auto &timer = *static_cast<InferenceTimer *>(user_data);
+		if (timer.encoding.exchange(false)) {
+			timer.encode_ms += ElapsedMs(timer.encode_start, ProfileClock::now());
+		}
+	}
+};
+
+static void AccumulateProfile(TranscriptionProfile &total, const TranscriptionProfile &part) {
+	total.threads = MaxValue<int>(total.threads, part.threads);
+	total.threads_in_use = MaxValue<int>(total.threads_in_use, part.threads_in_use);
+	total.model_load_ms += part.model_load_ms;
+	total.mel_ms += part.mel_ms;
+	total.encode_ms += part.encode_ms;
+	total.decode_ms += part.decode_ms;
+	total.inference_ms += part.inference_ms;
+}
+
+// Set the end-to-end time of a call and add it to whisper_stats()
+static void RecordProfile(TranscriptionResult &result, const std::string &model, double audio_decode_ms,
+                          ProfileClock::time_point inference_start) {
+	result.profile.audio_decode_ms = audio_decode_ms;
+	result.profile.total_ms = audio_decode_ms + ElapsedMs(inference_start, ProfileClock::now());
+	TranscriptionStats::GetInstance().RecordCall(model, result.profile);
+}
+
+static void RecordCacheHit(TranscriptionResult &result, const std::string &model, ProfileClock::time_point start) {
+	result.profile = TranscriptionProfile();
+	result.profile.cache_hit = true;
+	result.profile.total_ms = ElapsedMs(start, ProfileClock::now());
+	TranscriptionStats::GetInstance().RecordCall(model, result.profile);
+}
+
+// ============================================================================
+// Thread budget
+// ============================================================================
+
+static int HardwareThreads() {
+	return MaxValue<int>(static_cast<int>(std::thread::hardware_concurrency()), 1);
+}
+
+// ggml compute threads handed out to concurrent whisper runs (shared by all connections)
+// A DuckDB scan already runs one pipeline thread per core, so a run started from each of them must not use every
+// core as well. The budget is DuckDB's own thread count.
+class ThreadBudget {
+public:
+	static ThreadBudget &GetInstance() {
+		static ThreadBudget instance;
+		return instance;
+	}
+
+	// Threads for a new run (whisper_threads > 0 fixes the count; 'shared' still bounds it by the free threads)
+	// threads_in_use is set to the threads held by all runs, this one included.
+	int Acquire(const WhisperConfig &config, int &threads_in_use) {
+		int budget = config.scheduler_threads > 0 ? config.scheduler_threads : HardwareThreads();
+		std::unique_lock<std::mutex> lock(mutex_);
+		int threads;
+		if (config.threads_policy == "shared") {
+			// Wait for free threads so the runs together never exceed the budget
+			cv_.wait(lock, [&]() { return in_use_ < budget; });
+			threads = MinValue<int>(config.threads > 0 ? config.threads : budget, budget - in_use_);
+		} else if (config.threads > 0) {
+			threads = config.threads;
+		} else if (config.threads_policy == "per_call") {
+			threads = HardwareThreads();
+		} else {
+			// auto: an even share of the budget among the runs in flight (or the runs the caller is about to start),
+			// capped at the threads still free so later runs do not push the total past the budget; a run that
+			// finds none free still gets one
+			int runs = MaxValue<int>(active_runs_ + 1, config.concurrent_runs);
+			threads = MaxValue<int>(MinValue<int>(budget / runs, budget - in_use_), 1);
+		}
+		active_runs_++;
+		in_use_ += threads;
+		threads_in_use = in_use_;
+		return threads;
+	}
+
+	void Release(int threads) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			active_runs_--;
+			in_use_ -= threads;
+		}
+		cv_.notify_all();
+	}
+
+private:
+	ThreadBudget() = default;
+
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	int active_runs_ = 0;
+	int in_use_ = 0;
+};
+
+// RAII share of the thread budget for one whisper run
+class ThreadLease {
+public:
+	explicit ThreadLease(const WhisperConfig &config)
+	    : threads_in_use_(0), threads_(ThreadBudget::GetInstance().Acquire(config, threads_in_use_)) {
+	}
+	~ThreadLease() {
+		ThreadBudget::GetInstance().Release(threads_);
+	}
+
+	ThreadLease(const ThreadLease &) = delete;
+	ThreadLease &operator=(const ThreadLease &) = delete;
+
+	int Threads() const {
+		return threads_;
+	}
+	int ThreadsInUse() const {
+		return threads_in_use_;
+	}
+
+private:
+	int threads_in_use_;
+	int threads_;
+};
+
+// ============================================================================
+// Worker pool
+// ============================================================================
+
+// Copies of one batch's worker function, handed out in index order
+// A copy only ever waits on copies with a lower index, which are claimed (and so running) by the time it starts.
+struct WorkerRun {
+	std::function<void(idx_t)> worker;
+	idx_t n_workers = 0;
+	idx_t next_worker = 0;
+	idx_t finished = 0;
+	std::exception_ptr error;
+	std::mutex mutex;
+	std::condition_variable done;
+
+	bool Claim(idx_t &worker_idx) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (next_worker >= n_workers) {
+			return false;
+		}
+		worker_idx = next_worker++;
+		return true;
+	}
+
+	void Execute(idx_t worker_idx) {
+		std::exception_ptr worker_error;
+		try {
+			worker(worker_idx);
+		} catch (...) {
+			worker_error = std::current_exception();
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (worker_error && !error) {
+				error = worker_error;
+			}
+			finished++;
+		}
+		done.notify_all();
+	}
+};
+
+// Threads shared by the batches of every connection (one per core, started on first use)
+// A scalar call per DataChunk on each DuckDB thread used to start its own decode and inference threads; the pool
+// keeps the total bounded and keeps thread-local decoder scratch (see audio_utils.cpp) alive across chunks.
+class WorkerPool {
+public:
+	static WorkerPool &GetInstance() {
+		// Intentionally leaked like WhisperContextManager: the threads are never joined at exit
+		static WorkerPool *instance = new WorkerPool();
+		return *instance;
+	}
+
+	// Run worker(0) .. worker(n_workers - 1) concurrently and wait for all of them
+	// The calling thread runs the copies no pool thread has picked up yet, so a busy pool never stalls a batch.
+	void Run(idx_t n_workers, std::function<void(idx_t)> worker) {
+		auto run = std::make_shared<WorkerRun>();
+		run->worker = std::move(worker);
+		run->n_workers = n_workers;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (idx_t i = 1; i < n_workers; i++) {
+				queue_.push_back(run);
+			}
+		}
+		cv_.notify_all();
+
+		idx_t worker_idx;
+		while (run->Claim(worker_idx)) {
+			run->Execute(worker_idx);
+		}
+		std::unique_lock<std::mutex> lock(run->mutex);
+		run->done.wait(lock, [&]() { return run->finished == run->n_workers; });
+		if (run->error) {
+			std::rethrow_exception(run->error);
+		}
+	}
+
+private:
+	WorkerPool() {
+		for (int i = 0; i < HardwareThreads(); i++) {
+			std::thread(&WorkerPool::WorkLoop, this).detach();
+		}
+	}
+
+	void WorkLoop() {
+		while (true) {
+			std::shared_ptr<WorkerRun> run;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				cv_.wait(lock, [&]() { return !queue_.empty(); });
+				run = std::move(queue_.front());
+				queue_.pop_front();
+			}
+			// Stale entries (copies the caller already ran itself) are skipped
+			idx_t worker_idx;
+			if (run->Claim(worker_idx)) {
+				run->Execute(worker_idx);
+			}
+		}
+	}
+
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::deque<std::shared_ptr<WorkerRun>> queue_;
+};
+
+// Transcribe without recording the call (dispatches to VAD, parallel chunks or a single whisper run)
+static TranscriptionResult TranscribeSamples(const float *samples, size_t n_samples, const WhisperConfig &config);
+
+// Middle of the lowest-energy 20ms frame in samples[begin, end), where a cut will not split a word
+static constexpr size_t QUIET_FRAME_SAMPLES = 16000 / 50;
+
+static size_t FindQuietPoint(const float *samples, size_t begin, size_t end) {
+	size_t best_cut = end;
+	double best_energy = -1.0;
+	for (size_t frame = begin; frame + QUIET_FRAME_SAMPLES <= end; frame += QUIET_FRAME_SAMPLES) {
+		double energy = 0.0;
+		for (size_t i = frame; i < frame + QUIET_FRAME_SAMPLES; i++) {
+			energy += static_cast<double>(samples[i]) * samples[i];
+		}
+		if (best_energy < 0.0 || energy < best_energy) {
+			best_energy = energy;
+			best_cut = frame + QUIET_FRAME_SAMPLES / 2;
+		}
+	}
+	return best_cut;
+}
+
+// ============================================================================
+// Voice activity detection
+// ============================================================================
+
+static constexpr size_t VAD_SAMPLE_RATE = 16000;
+static constexpr size_t VAD_GAP_SAMPLES = VAD_SAMPLE_RATE / 10; // Silence kept between joined speech spans
+
+// A speech span copied into the compacted buffer
+struct CompactedSpan {
+	size_t source_start;  // Offset in the original audio
+	size_t compact_start; // Offset in the compacted audio
+	size_t length;
+};
+
+// Map a time in the compacted audio back to the original timeline
+// Times falling into an inserted gap snap to the neighbouring span edge.
+static double RemapTime(const std::vector<CompactedSpan> &spans, double seconds, bool is_end) {
+	double sample = seconds * static_cast<double>(VAD_SAMPLE_RATE);
+	const CompactedSpan *span = &spans.front();
+	for (auto &candidate : spans) {
+		if (static_cast<double>(candidate.compact_start) > sample) {
+			// In the gap before this span: starts snap forward, ends snap back
+			if (!is_end && sample >= static_cast<double>(span->compact_start + span->length)) {
+				span = &candidate;
+			}
+			break;
+		}
+		span = &candidate;
+	}
+	double offset = sample - static_cast<double>(span->compact_start);
+	offset = MaxValue<double>(0.0, MinValue<double>(offset, static_cast<double>(span->length)));
+	return (static_cast<double>(span->source_start) + offset) / static_cast<double>(VAD_SAMPLE_RATE);
+}
+
+// Transcribe only the detected speech, then map segment timestamps back to the input timeline
+static TranscriptionResult TranscribeSpeech(const float *samples, size_t n_samples, const WhisperConfig &config) {
+	WhisperConfig speech_config = config;
+	speech_config.vad = false;
+
+	auto speech = VoiceActivityDetector::DetectSpeech(samples, n_samples, static_cast<float>(config.vad_threshold));
+	if (speech.empty()) {
+		TranscriptionResult result;
+		result.detected_language = "unknown";
+		result.success = true;
+		result.profile.audio_seconds = static_cast<double>(n_samples) / static_cast<double>(VAD_SAMPLE_RATE);
+		return result;
+	}
+
+	size_t speech_samples = 0;
+	for (auto &span : speech) {
+		speech_samples += span.end - span.start;
+	}
+	if (speech_samples + VAD_GAP_SAMPLES * speech.size() >= n_samples) {
+		// Nothing worth skipping
+		return TranscribeSamples(samples, n_samples, speech_config);
+	}
+
+	// Join the speech spans, separated by short gaps of silence
+	std::vector<float> compacted;
+	compacted.reserve(speech_samples + VAD_GAP_SAMPLES * speech.size());
+	std::vector<CompactedSpan> spans;
+	spans.reserve(speech.size());
+	for (auto &span : speech) {
+		if (!compacted.empty()) {
+			compacted.insert(compacted.end(), VAD_GAP_SAMPLES, 0.0f);
+		}
+		spans.push_back({span.start, compacted.size(), span.end - span.start});
+		compacted.insert(compacted.end(), samples + span.start, samples + span.end);
+	}
+
+	auto result = TranscribeSamples(compacted.data(), compacted.size(), speech_config);
+	for (auto &segment : result.segments) {
+		MapSegmentTimes(segment, [&](double seconds, bool is_end) { return RemapTime(spans, seconds, is_end); });
+	}
+	result.profile.audio_seconds = static_cast<double>(n_samples) / static_cast<double>(VAD_SAMPLE_RATE);
+	return result;
+}
+
+// ============================================================================
+// Parallel chunks
+// ============================================================================
+
+static constexpr size_t CHUNK_SAMPLE_RATE = 16000;
+static constexpr size_t MIN_CHUNK_SAMPLES = CHUNK_SAMPLE_RATE * 60;    // Shorter chunks are not worth a state
+static constexpr size_t CHUNK_SEARCH_SAMPLES = CHUNK_SAMPLE_RATE * 10; // Look this far around each even split
+
+// Split long audio at quiet points and transcribe the chunks concurrently on separate decoder states
+// Segments are stitched back in order with timestamps relative to the whole input.
+static TranscriptionResult TranscribeChunks(const float *samples, size_t n_samples, const WhisperConfig &config) {
+	WhisperConfig chunk_config = config;
+	chunk_config.parallel_chunks = 1;
+
+	size_t n_chunks = MinValue<size_t>(static_cast<size_t>(config.parallel_chunks), n_samples / MIN_CHUNK_SAMPLES);
+	if (n_chunks < 2) {
+		return TranscribeSamples(samples, n_samples, chunk_config);
+	}
+
+	// Chunk boundaries: the quietest frame near each even split point
+	std::vector<size_t> bounds;
+	bounds.reserve(n_chunks + 1);
+	bounds.push_back(0);
+	for (size_t k = 1; k < n_chunks; k++) {
+		size_t target = n_samples / n_chunks * k;
+		size_t begin = MaxValue<size_t>(bounds.back() + QUIET_FRAME_SAMPLES, target - CHUNK_SEARCH_SAMPLES);
+		size_t end = MinValue<size_t>(n_samples, target + CHUNK_SEARCH_SAMPLES);
+		bounds.push_back(begin < end ? FindQuietPoint(samples, begin, end) : target);
+	}
+	bounds.push_back(n_samples);
+
+	// Share the threads between the chunks instead of oversubscribing the cores
+	// (without a fixed count, the auto and shared policies split the budget as the chunks start)
+	if (config.threads > 0 || config.threads_policy == "per_call") {
+		int total_threads = config.threads > 0 ? config.threads : HardwareThreads();
+		chunk_config.threads = MaxValue<int>(total_threads / static_cast<int>(n_chunks), 1);
+	}
+
+	// Chunks never wait on each other, so any claim order is safe (and a busy pool leaves them to the caller)
+	std::vector<TranscriptionResult> chunk_results(n_chunks);
+	WorkerPool::GetInstance().Run(n_chunks, [&](idx_t k) {
+		chunk_results[k] = TranscribeSamples(samples + bounds[k], bounds[k + 1] - bounds[k], chunk_config);
+	});
+
 	TranscriptionResult result;
 	result.success = false;
+	result.detected_language = "unknown";
+	result.profile.audio_seconds = static_cast<double>(n_samples) / static_cast<double>(CHUNK_SAMPLE_RATE);
+	int next_segment_id = 0;
+	for (size_t k = 0; k < n_chunks; k++) {
+		auto &chunk = chunk_results[k];
+		AccumulateProfile(result.profile, chunk.profile);
+		if (!chunk.success) {
+			result.error = chunk.error;
+			return result;
+		}
 
-	if (pcm_data.empty()) {
-		result.error = "Empty audio data";
-		return result;
+		double offset = static_cast<double>(bounds[k]) / static_cast<double>(CHUNK_SAMPLE_RATE);
+		for (auto &segment : chunk.segments) {
+			segment.segment_id = next_segment_id++;
+			MapSegmentTimes(segment, [offset](double seconds, bool) { return seconds + offset; });
+			result.segments.push_back(std::move(segment));
+		}
+		if (!chunk.full_text.empty()) {
+			if (!result.full_text.empty()) {
+				result.full_text += " ";
+			}
+			result.full_text += chunk.full_text;
+		}
+	}
+	if (!result.segments.empty()) {
+		result.detected_language = result.segments[0].language;
 	}
+	result.success = true;
+	return result;
+}
+
+TranscriptionResult TranscriptionEngine::TranscribePCM(const std::vector<float> &pcm_data,
+                                                       const WhisperConfig &config) {
+	return TranscribePCM(pcm_data.data(), pcm_data.size(), config);
+}
+
+TranscriptionResult TranscriptionEngine::TranscribePCM(const float *samples, size_t n_samples,
+                                                       const WhisperConfig &config) {
+	auto start = ProfileClock::now();
+	auto result = TranscribeSamples(samples, n_samples, config);
+	RecordProfile(result, config.model, 0.0, start);
+	return result;
+}
 
-	// Get model path
+TranscriptionResult TranscriptionEngine::TranscribePass(const float *samples, size_t n_samples,
+                                                        const WhisperConfig &config) {
+	auto start = ProfileClock::now();
+	auto result = TranscribeSamples(samples, n_samples, config);
+	result.profile.total_ms = ElapsedMs(start, ProfileClock::now());
+	return result;
+}
+
+// Get (or load) the whisper context of config.model; returns nullptr and sets error when it cannot be loaded
+static std::shared_ptr<WhisperContextWrapper> AcquireContext(const WhisperConfig &config, double &model_load_ms,
+                                                             std::string &error) {
 	std::string model_path = ModelManager::GetModelPath(config.model, config.model_path);
 
-	// Get or create whisper context
 	std::string ctx_error;
-	auto ctx_wrapper = WhisperContextManager::GetInstance().GetContext(model_path, config.use_gpu, ctx_error);
+	idx_t budget_mb = static_cast<idx_t>(MaxValue(config.model_cache_mb, 0));
+	auto &context_manager = WhisperContextManager::GetInstance();
+	bool loaded = false;
+	auto load_start = ProfileClock::now();
+	auto ctx_wrapper =
+	    context_manager.GetContext(model_path, config.use_gpu, config.gpu_device, config.flash_attn, budget_mb,
+	                               ctx_error, &loaded);
+	model_load_ms = ElapsedMs(load_start, ProfileClock::now());
+	if (loaded) {
+		TranscriptionStats::GetInstance().RecordModelLoad(config.model, model_load_ms);
+	}
 	if (!ctx_wrapper || !ctx_wrapper->IsValid()) {
-		result.error = ctx_error.empty() ? "Failed to load model" : ctx_error;
+		error = ctx_error.empty() ? "Failed to load model" : ctx_error;
+		return nullptr;
+	}
+	return ctx_wrapper;
+}
+
+bool TranscriptionEngine::CheckConfig(const WhisperConfig &config, std::string &error) {
+	double model_load_ms = 0.0;
+	auto ctx_wrapper = AcquireContext(config, model_load_ms, error);
+	if (!ctx_wrapper) {
+		return false;
+	}
+	if (config.translate && !whisper_is_multilingual(ctx_wrapper->Get())) {
+		error = "Translation requires a multilingual model. English-only models (.en) do not support translation.";
+		return false;
+	}
+	return true;
+}
+
+// A single whisper run over the whole input
+static TranscriptionResult RunWhisper(const float *samples, size_t n_samples, const WhisperConfig &config) {
+	TranscriptionResult result;
+	result.success = false;
+	result.profile.audio_seconds = static_cast<double>(n_samples) / static_cast<double>(WHISPER_SAMPLE_RATE);
+
+	auto ctx_wrapper = AcquireContext(config, result.profile.model_load_ms, result.error);
+	if (!ctx_wrapper) {
 		return result;
 	}
 
@@ -68,7 +590,9 @@ TranscriptionResult TranscriptionEngine::TranscribePCM(const std::vector<float>
 	}
 
 	// Configure whisper parameters
-	whisper_full_params wparams = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+	bool beam_search = config.beam_size > 1;
+	whisper_full_params wparams =
+	    whisper_full_default_params(beam_search ? WHISPER_SAMPLING_BEAM_SEARCH : WHISPER_SAMPLING_GREEDY);
 
 	// Set language
 	if (config.language != "auto") {
@@ -77,13 +601,6 @@ TranscriptionResult TranscriptionEngine::TranscribePCM(const std::vector<float>
 		wparams.language = nullptr; // Auto-detect
 	}
 
-	// Set thread count (use all available cores by default)
-	if (config.threads > 0) {
-		wparams.n_threads = config.threads;
-	} else {
-		wparams.n_threads = static_cast<int>(std::thread::hardware_concurrency());
-	}
-
 	// Other settings
 	wparams.print_progress = false;
 	wparams.print_special = false;
@@ -92,34 +609,74 @@ TranscriptionResult TranscriptionEngine::TranscribePCM(const std::vector<float>
 	wparams.translate = config.translate;
 	wparams.single_segment = false;
 	wparams.max_len = config.max_segment_length / 10; // max_len is in tokens, rough approximation
+	wparams.token_timestamps = config.collect_tokens && config.token_timestamps;
 
-	// Run transcription
-	int ret = whisper_full(ctx, wparams, pcm_data.data(), pcm_data.size());
+	// Decoder tuning (accuracy vs. speed)
+	if (beam_search) {
+		wparams.beam_search.beam_size = config.beam_size;
+	}
+	wparams.greedy.best_of = MaxValue(config.best_of, 1);
+	wparams.temperature = static_cast<float>(config.temperature);
+	wparams.temperature_inc = static_cast<float>(config.temperature_inc);
+	wparams.entropy_thold = static_cast<float>(config.entropy_thold);
+	wparams.no_context = config.no_context;
+	wparams.audio_ctx = MaxValue(config.audio_ctx, 0);
+
+	// Check out a decoder state so concurrent calls share the model weights
+	std::string state_error;
+	WhisperStateLease lease(ctx_wrapper, static_cast<idx_t>(MaxValue<int>(config.max_concurrent_states, 1)),
+	                        state_error);
+	if (!lease.IsValid()) {
+		result.error = state_error.empty() ? "Failed to allocate whisper decoder state" : state_error;
+		return result;
+	}
+	whisper_state *wstate = lease.Get();
+
+	// Take this run's share of the threads only once a decoder state is available
+	ThreadLease threads(config);
+	wparams.n_threads = threads.Threads();
+	result.profile.threads = threads.Threads();
+	result.profile.threads_in_use = threads.ThreadsInUse();
+
+	// Run transcription, timing its stages
+	InferenceTimer timer;
+	wparams.encoder_begin_callback = InferenceTimer::OnEncoderBegin;
+	wparams.encoder_begin_callback_user_data = &timer;
+	wparams.logits_filter_callback = InferenceTimer::OnLogitsFilter;
+	wparams.logits_filter_callback_user_data = &timer;
+
+	timer.start = ProfileClock::now();
+	int ret = whisper_full_with_state(ctx, wstate, wparams, samples, static_cast<int>(n_samples));
+	result.profile.inference_ms = ElapsedMs(timer.start, ProfileClock::now());
+	result.profile.mel_ms = timer.mel_ms;
+	result.profile.encode_ms = timer.encode_ms;
+	result.profile.decode_ms = MaxValue<double>(result.profile.inference_ms - timer.mel_ms - timer.encode_ms, 0.0);
 	if (ret != 0) {
 		result.error = "Transcription failed with error code: " + std::to_string(ret);
 		return result;
 	}
 
-	// Extract results
-	int n_segments = whisper_full_n_segments(ctx);
+	// Extract results (the language is decided once per run, before the first segment is decoded)
+	int n_segments = whisper_full_n_segments_from_state(wstate);
 	result.segments.reserve(n_segments);
+	std::string language = GetLanguageCode(whisper_full_lang_id_from_state(wstate));
 
 	std::string full_text;
 
 	for (int i = 0; i < n_segments; i++) {
 		TranscriptionSegment segment;
 		segment.segment_id = i;
-		segment.start_time = static_cast<double>(whisper_full_get_segment_t0(ctx, i)) / 100.0;
-		segment.end_time = static_cast<double>(whisper_full_get_segment_t1(ctx, i)) / 100.0;
+		segment.start_time = static_cast<double>(whisper_full_get_segment_t0_from_state(wstate, i)) / 100.0;
+		segment.end_time = static_cast<double>(whisper_full_get_segment_t1_from_state(wstate, i)) / 100.0;
 
-		const char *text = whisper_full_get_segment_text(ctx, i);
+		const char *text = whisper_full_get_segment_text_from_state(wstate, i);
 		segment.text = text ? text : "";
 
-		segment.confidence = CalculateSegmentConfidence(ctx, i);
+		if (config.segment_confidence || config.collect_tokens) {
+			ReadSegmentTokens(ctx, wstate, i, config, segment);
+		}
 
-		// Get language for this segment
-		int lang_id = whisper_full_lang_id(ctx);
-		segment.language = GetLanguageCode(lang_id);
+		segment.language = language;
 
 		result.segments.push_back(segment);
 
@@ -131,16 +688,67 @@ TranscriptionResult TranscriptionEngine::TranscribePCM(const std::vector<float>
 	}
 
 	result.full_text = full_text;
-	result.detected_language = !result.segments.empty() ? result.segments[0].language : "unknown";
+	result.detected_language = !result.segments.empty() ? language : "unknown";
 	result.success = true;
 
 	return result;
 }
 
+static TranscriptionResult TranscribeSamples(const float *samples, size_t n_samples, const WhisperConfig &config) {
+	if (!samples || n_samples == 0) {
+		TranscriptionResult result;
+		result.success = false;
+		result.error = "Empty audio data";
+		return result;
+	}
+
+	if (config.vad) {
+		return TranscribeSpeech(samples, n_samples, config);
+	}
+	if (config.parallel_chunks > 1) {
+		return TranscribeChunks(samples, n_samples, config);
+	}
+	return RunWhisper(samples, n_samples, config);
+}
+
+static bool HasRange(const WhisperConfig &config) {
+	return config.range_start > 0.0 || config.range_end >= 0.0;
+}
+
+// Transcribe audio decoded from config.range_start on, placing the segments on the input's timeline
+static TranscriptionResult TranscribeRange(const std::vector<float> &pcm_data, const WhisperConfig &config) {
+	if (!HasRange(config)) {
+		return TranscribeSamples(pcm_data.data(), pcm_data.size(), config);
+	}
+
+	// A range past the end of the input (or an empty one) holds no segments
+	if (pcm_data.empty()) {
+		TranscriptionResult result;
+		result.success = true;
+		return result;
+	}
+
+	auto result = TranscribeSamples(pcm_data.data(), pcm_data.size(), config);
+	double offset = MaxValue<double>(config.range_start, 0.0);
+	for (auto &segment : result.segments) {
+		MapSegmentTimes(segment, [offset](double seconds, bool) { return seconds + offset; });
+	}
+	return result;
+}
+
 TranscriptionResult TranscriptionEngine::TranscribeFile(const std::string &file_path, const WhisperConfig &config) {
 	TranscriptionResult result;
 	result.success = false;
 
+	// Serve repeated transcriptions of an unchanged file from the cache
+	auto start = ProfileClock::now();
+	std::string cache_key;
+	bool use_cache = config.cache && TranscriptionCache::FileKey(file_path, config, cache_key);
+	if (use_cache && TranscriptionCache::GetInstance().Lookup(cache_key, config, result)) {
+		RecordCacheHit(result, config.model, start);
+		return result;
+	}
+
 	// Configure FFmpeg logging based on settings
 	AudioUtils::SetFFmpegLogging(config.ffmpeg_logging);
 
@@ -148,12 +756,21 @@ TranscriptionResult TranscriptionEngine::TranscribeFile(const std::string &file_
 	std::vector<float> pcm_data;
 	std::string load_error;
 
-	if (!AudioUtils::LoadAudioFile(file_path, pcm_data, load_error)) {
+	bool loaded = HasRange(config) ? AudioUtils::LoadAudioFileRange(file_path, config.input_format, config.range_start,
+	                                                                config.range_end, pcm_data, load_error)
+	                               : AudioUtils::LoadAudioFile(file_path, config.input_format, pcm_data, load_error);
+	if (!loaded) {
 		result.error = "Failed to load audio: " + load_error;
 		return result;
 	}
 
-	return TranscribePCM(pcm_data, config);
+	auto inference_start = ProfileClock::now();
+	result = TranscribeRange(pcm_data, config);
+	RecordProfile(result, config.model, ElapsedMs(start, inference_start), inference_start);
+	if (use_cache) {
+		TranscriptionCache::GetInstance().Store(cache_key, config, result);
+	}
+	return result;
 }
 
 TranscriptionResult TranscriptionEngine::TranscribeMemory(const uint8_t *data, size_t size,
@@ -161,6 +778,17 @@ TranscriptionResult TranscriptionEngine::TranscribeMemory(const uint8_t *data, s
 	TranscriptionResult result;
 	result.success = false;
 
+	// Serve repeated transcriptions of identical audio from the cache
+	auto start = ProfileClock::now();
+	std::string cache_key;
+	if (config.cache) {
+		cache_key = TranscriptionCache::MemoryKey(data, size, config);
+		if (TranscriptionCache::GetInstance().Lookup(cache_key, config, result)) {
+			RecordCacheHit(result, config.model, start);
+			return result;
+		}
+	}
+
 	// Configure FFmpeg logging based on settings
 	AudioUtils::SetFFmpegLogging(config.ffmpeg_logging);
 
@@ -168,12 +796,728 @@ TranscriptionResult TranscriptionEngine::TranscribeMemory(const uint8_t *data, s
 	std::vector<float> pcm_data;
 	std::string load_error;
 
-	if (!AudioUtils::LoadAudioFromMemory(data, size, pcm_data, load_error)) {
+	bool loaded = HasRange(config) ? AudioUtils::LoadAudioFromMemoryRange(data, size, config.input_format,
+	                                                                      config.range_start, config.range_end,
+	                                                                      pcm_data, load_error)
+	                               : AudioUtils::LoadAudioFromMemory(data, size, config.input_format, pcm_data,
+	                                                                 load_error);
+	if (!loaded) {
 		result.error = "Failed to load audio from memory: " + load_error;
 		return result;
 	}
 
-	return TranscribePCM(pcm_data, config);
+	auto inference_start = ProfileClock::now();
+	result = TranscribeRange(pcm_data, config);
+	RecordProfile(result, config.model, ElapsedMs(start, inference_start), inference_start);
+	if (config.cache) {
+		TranscriptionCache::GetInstance().Store(cache_key, config, result);
+	}
+	return result;
+}
+
+// ============================================================================
+// Batch transcription
+// ============================================================================
+
+// Decoded audio handed from the decode stage to the inference stage
+struct DecodedAudio {
+	idx_t index;
+	std::vector<float> pcm;
+	double decode_ms;
+};
+
+// Bounded queue between the decode and inference stages
+// Bounding it limits how much decoded PCM is resident at once.
+class DecodedAudioQueue {
+public:
+	DecodedAudioQueue(idx_t capacity, idx_t producers) : capacity_(capacity), producers_(producers) {
+	}
+
+	// Add an item unless the queue is full, in which case the caller keeps it
+	// Decoders never wait for a slot: with a shared worker pool, the inference workers may not have started yet.
+	bool TryPush(DecodedAudio &item) {
+		std::unique_lock<std::mutex> lock(mutex_);
+		if (items_.size() >= capacity_) {
+			return false;
+		}
+		items_.push_back(std::move(item));
+		lock.unlock();
+		not_empty_.notify_one();
+		return true;
+	}
+
+	// Returns false once all producers are done and the queue is drained
+	bool Pop(DecodedAudio &item) {
+		std::unique_lock<std::mutex> lock(mutex_);
+		not_empty_.wait(lock, [&]() { return !items_.empty() || producers_ == 0; });
+		if (items_.empty()) {
+			return false;
+		}
+		item = std::move(items_.front());
+		items_.pop_front();
+		return true;
+	}
+
+	void ProducerDone() {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			producers_--;
+		}
+		not_empty_.notify_all();
+	}
+
+private:
+	std::mutex mutex_;
+	std::condition_variable not_empty_;
+	std::deque<DecodedAudio> items_;
+	idx_t capacity_;
+	idx_t producers_;
+};
+
+static bool DecodeInput(const TranscriptionInput &input, const WhisperConfig &config, std::vector<float> &pcm_data,
+                        double &decode_ms, std::string &error) {
+	auto start = ProfileClock::now();
+	std::string load_error;
+	if (input.is_blob) {
+		if (!AudioUtils::LoadAudioFromMemory(input.data, input.size, config.input_format, pcm_data, load_error)) {
+			error = "Failed to load audio from memory: " + load_error;
+			return false;
+		}
+	} else if (!AudioUtils::LoadAudioFile(input.file_path, config.input_format, pcm_data, load_error)) {
+		error = "Failed to load audio: " + load_error;
+		return false;
+	}
+	decode_ms = ElapsedMs(start, ProfileClock::now());
+	return true;
+}
+
+// Config with the input's model override applied (local_config is only filled when needed)
+static const WhisperConfig &ResolveInputConfig(const TranscriptionInput &input, const WhisperConfig &config,
+                                               WhisperConfig &local_config) {
+	if (input.model.empty() || input.model == config.model) {
+		return config;
+	}
+	local_config = config;
+	local_config.model = input.model;
+	return local_config;
+}
+
+// Check the cache for an input; cache_key is set when the result should be stored after inference
+static bool LookupCachedInput(const TranscriptionInput &input, const WhisperConfig &config, std::string &cache_key,
+                              TranscriptionResult &result) {
+	WhisperConfig local_config;
+	auto &input_config = ResolveInputConfig(input, config, local_config);
+	auto start = ProfileClock::now();
+	if (input.is_blob) {
+		cache_key = TranscriptionCache::MemoryKey(input.data, input.size, input_config);
+	} else if (!TranscriptionCache::FileKey(input.file_path, input_config, cache_key)) {
+		return false;
+	}
+	if (!TranscriptionCache::GetInstance().Lookup(cache_key, input_config, result)) {
+		return false;
+	}
+	RecordCacheHit(result, input_config.model, start);
+	return true;
+}
+
+static TranscriptionResult InferDecoded(const TranscriptionInput &input, const std::vector<float> &pcm_data,
+                                        double decode_ms, const WhisperConfig &config, const std::string &cache_key) {
+	WhisperConfig local_config;
+	auto &input_config = ResolveInputConfig(input, config, local_config);
+	auto inference_start = ProfileClock::now();
+	auto result = TranscribeSamples(pcm_data.data(), pcm_data.size(), input_config);
+	RecordProfile(result, input_config.model, decode_ms, inference_start);
+	if (!cache_key.empty()) {
+		TranscriptionCache::GetInstance().Store(cache_key, input_config, result);
+	}
+	return result;
+}
+
+// Short clips packed into one 30 second whisper window, separated by silence
+// whisper pads every input to 30 seconds, so transcribing a pack costs about as much as a single clip.
+// Segments are handed back to the clip that contains their midpoint, stage times in proportion to its length.
+class ClipPack {
+public:
+	static constexpr size_t SAMPLE_RATE = 16000;
+	static constexpr size_t WINDOW_SAMPLES = SAMPLE_RATE * 30;
+	static constexpr size_t GAP_SAMPLES = SAMPLE_RATE; // Silence between clips so segments break there
+	// Overlap with a clip below this is timestamp jitter, not speech of that clip
+	static constexpr size_t OVERLAP_TOLERANCE_SAMPLES = SAMPLE_RATE / 10;
+
+	// Whether a clip is short enough to be packed at all
+	static bool IsPackable(size_t n_samples) {
+		return n_samples > 0 && n_samples + GAP_SAMPLES <= WINDOW_SAMPLES;
+	}
+
+	// Whether clips transcribed with a config may share a window
+	// A pack is decoded in one language, so with language = 'auto' a multilingual model would transcribe every clip
+	// in the language that wins for the whole window. English-only models and a fixed language are safe.
+	// With language = 'auto' this looks the model up, so batches resolve it once per model.
+	static bool CanPackLanguage(const WhisperConfig &config) {
+		if (config.language != "auto") {
+			return true;
+		}
+		double model_load_ms = 0.0;
+		std::string error;
+		auto ctx_wrapper = AcquireContext(config, model_load_ms, error);
+		return ctx_wrapper && !whisper_is_multilingual(ctx_wrapper->Get());
+	}
+
+	bool Empty() const {
+		return clips_.empty();
+	}
+
+	// Whether a clip fits into this pack (all clips of a pack must use the same model)
+	bool Fits(size_t n_samples, const std::string &model) const {
+		return clips_.empty() || (model == model_ && pcm_.size() + GAP_SAMPLES + n_samples <= WINDOW_SAMPLES);
+	}
+
+	void Add(idx_t index, const std::vector<float> &pcm, double decode_ms, const std::string &model) {
+		if (clips_.empty()) {
+			model_ = model;
+		} else {
+			pcm_.insert(pcm_.end(), GAP_SAMPLES, 0.0f);
+		}
+		clips_.push_back({index, pcm_.size(), pcm.size(), decode_ms});
+		pcm_.insert(pcm_.end(), pcm.begin(), pcm.end());
+	}
+
+	// Transcribe the pack, write each clip's result and reset the pack
+	void Transcribe(const std::vector<TranscriptionInput> &inputs, const WhisperConfig &config,
+	                const std::vector<std::string> &cache_keys, std::vector<TranscriptionResult> &results) {
+		if (clips_.size() == 1) {
+			auto &clip = clips_[0];
+			try {
+				results[clip.index] =
+				    InferDecoded(inputs[clip.index], pcm_, clip.decode_ms, config, cache_keys[clip.index]);
+			} catch (std::exception &ex) {
+				results[clip.index].success = false;
+				results[clip.index].error = ex.what();
+			}
+			Reset();
+			return;
+		}
+
+		WhisperConfig local_config;
+		auto &pack_config = ResolveInputConfig(inputs[clips_[0].index], config, local_config);
+		TranscriptionResult pack_result;
+		auto inference_start = ProfileClock::now();
+		try {
+			pack_result = TranscribeSamples(pcm_.data(), pcm_.size(), pack_config);
+		} catch (std::exception &ex) {
+			// Every clip of the pack needs a result, so report the failure to all of them
+			pack_result.success = false;
+			pack_result.error = ex.what();
+		}
+		double pack_ms = ElapsedMs(inference_start, ProfileClock::now());
+
+		// The silence between clips does not always end a segment; a segment spanning two clips cannot be split
+		// between their rows, so those clips are transcribed again on their own
+		std::vector<idx_t> owners(pack_result.segments.size());
+		std::vector<bool> unpack(clips_.size(), false);
+		for (idx_t i = 0; i < pack_result.segments.size(); i++) {
+			owners[i] = SegmentOwner(pack_result.segments[i], unpack);
+		}
+
+		for (idx_t k = 0; k < clips_.size(); k++) {
+			if (unpack[k]) {
+				continue;
+			}
+			auto &clip = clips_[k];
+			auto &result = results[clip.index];
+			result = TranscriptionResult();
+			result.success = pack_result.success;
+			result.error = pack_result.error;
+			result.detected_language = pack_result.detected_language;
+
+			double share = static_cast<double>(clip.length) / static_cast<double>(pcm_.size());
+			auto &profile = result.profile;
+			profile.threads = pack_result.profile.threads;
+			profile.threads_in_use = pack_result.profile.threads_in_use;
+			profile.audio_seconds = static_cast<double>(clip.length) / static_cast<double>(SAMPLE_RATE);
+			profile.audio_decode_ms = clip.decode_ms;
+			profile.model_load_ms = pack_result.profile.model_load_ms * share;
+			profile.mel_ms = pack_result.profile.mel_ms * share;
+			profile.encode_ms = pack_result.profile.encode_ms * share;
+			profile.decode_ms = pack_result.profile.decode_ms * share;
+			profile.inference_ms = pack_result.profile.inference_ms * share;
+			profile.total_ms = clip.decode_ms + pack_ms * share;
+			TranscriptionStats::GetInstance().RecordCall(pack_config.model, profile);
+		}
+
+		for (idx_t i = 0; i < pack_result.segments.size(); i++) {
+			if (unpack[owners[i]]) {
+				continue;
+			}
+			auto &segment = pack_result.segments[i];
+			const Clip *owner = &clips_[owners[i]];
+			auto &result = results[owner->index];
+			double offset = static_cast<double>(owner->offset) / static_cast<double>(SAMPLE_RATE);
+			double duration = static_cast<double>(owner->length) / static_cast<double>(SAMPLE_RATE);
+			segment.segment_id = static_cast<int>(result.segments.size());
+			MapSegmentTimes(segment, [offset, duration](double seconds, bool) {
+				return MinValue<double>(MaxValue<double>(seconds - offset, 0.0), duration);
+			});
+			if (!result.full_text.empty() && !segment.text.empty()) {
+				result.full_text += " ";
+			}
+			result.full_text += segment.text;
+			if (result.segments.empty()) {
+				result.detected_language = segment.language;
+			}
+			result.segments.push_back(std::move(segment));
+		}
+
+		for (idx_t k = 0; k < clips_.size(); k++) {
+			auto &clip = clips_[k];
+			if (unpack[k]) {
+				std::vector<float> clip_pcm(pcm_.begin() + clip.offset, pcm_.begin() + clip.offset + clip.length);
+				try {
+					results[clip.index] =
+					    InferDecoded(inputs[clip.index], clip_pcm, clip.decode_ms, config, cache_keys[clip.index]);
+				} catch (std::exception &ex) {
+					results[clip.index].success = false;
+					results[clip.index].error = ex.what();
+				}
+			} else if (pack_result.success && !cache_keys[clip.index].empty()) {
+				TranscriptionCache::GetInstance().Store(cache_keys[clip.index], pack_config, results[clip.index]);
+			}
+		}
+		Reset();
+	}
+
+private:
+	struct Clip {
+		idx_t index;   // Input index
+		size_t offset; // First sample in the packed buffer
+		size_t length;
+		double decode_ms;
+	};
+
+	void Reset() {
+		clips_.clear();
+		pcm_.clear();
+		model_.clear();
+	}
+
+	// Clip a packed segment belongs to: the one clip whose audio it overlaps, or the one containing its midpoint
+	// when it lies in a gap. Every clip of a segment overlapping several is marked in unpack.
+	idx_t SegmentOwner(const TranscriptionSegment &segment, std::vector<bool> &unpack) const {
+		double start = segment.start_time * static_cast<double>(SAMPLE_RATE);
+		double end = segment.end_time * static_cast<double>(SAMPLE_RATE);
+		std::vector<idx_t> overlapped;
+		for (idx_t k = 0; k < clips_.size(); k++) {
+			double clip_start = static_cast<double>(clips_[k].offset);
+			double clip_end = clip_start + static_cast<double>(clips_[k].length);
+			if (MinValue(end, clip_end) - MaxValue(start, clip_start) > OVERLAP_TOLERANCE_SAMPLES) {
+				overlapped.push_back(k);
+			}
+		}
+		if (overlapped.size() > 1) {
+			for (auto k : overlapped) {
+				unpack[k] = true;
+			}
+		}
+		if (!overlapped.empty()) {
+			return overlapped[0];
+		}
+
+		idx_t owner = 0;
+		double midpoint = (start + end) / 2.0;
+		for (idx_t k = 0; k < clips_.size() && static_cast<double>(clips_[k].offset) <= midpoint; k++) {
+			owner = k;
+		}
+		return owner;
+	}
+
+	std::vector<Clip> clips_;
+	std::vector<float> pcm_;
+	std::string model_;
+};
+
+std::vector<TranscriptionResult> TranscriptionEngine::TranscribeBatch(const std::vector<TranscriptionInput> &inputs,
+                                                                      const WhisperConfig &batch_config,
+                                                                      bool stop_on_error) {
+	WhisperConfig config = batch_config;
+	std::vector<TranscriptionResult> results(inputs.size());
+	if (inputs.empty()) {
+		return results;
+	}
+
+	// Resolve cache hits up front so they skip both stages
+	std::vector<std::string> cache_keys(inputs.size());
+	std::vector<idx_t> pending;
+	pending.reserve(inputs.size());
+	for (idx_t i = 0; i < inputs.size(); i++) {
+		if (config.cache && LookupCachedInput(inputs[i], config, cache_keys[i], results[i])) {
+			continue;
+		}
+		pending.push_back(i);
+	}
+	if (pending.empty()) {
+		return results;
+	}
+
+	// Configure FFmpeg logging based on settings
+	AudioUtils::SetFFmpegLogging(config.ffmpeg_logging);
+
+	// One decoder per inference slot (on every GPU transcriptions are spread across) keeps both stages busy
+	// without over-decoding
+	idx_t max_states = static_cast<idx_t>(MaxValue<int>(config.max_concurrent_states, 1)) *
+	                   WhisperContextManager::ScheduledDeviceCount(config.use_gpu, config.gpu_device);
+	idx_t n_workers = MinValue<idx_t>(pending.size(), max_states);
+	config.concurrent_runs = MaxValue<int>(config.concurrent_runs, static_cast<int>(n_workers));
+
+	// With stop_on_error, the first failure stops handing out inputs; inputs already started still finish
+	std::atomic<bool> stopped(false);
+	auto fail = [&](idx_t index, const std::string &error) {
+		results[index].success = false;
+		results[index].error = error;
+		if (stop_on_error) {
+			stopped = true;
+		}
+	};
+
+	// Model an input is transcribed with (packs never mix models)
+	auto input_model = [&](idx_t index) -> const std::string & {
+		return inputs[index].model.empty() ? config.model : inputs[index].model;
+	};
+
+	// Whether an input's clips may be packed, resolved once per model of the batch
+	std::mutex pack_language_mutex;
+	std::unordered_map<std::string, bool> pack_language;
+	auto can_pack_language = [&](idx_t index) {
+		if (config.language != "auto") {
+			return true;
+		}
+		std::lock_guard<std::mutex> lock(pack_language_mutex);
+		auto entry = pack_language.find(input_model(index));
+		if (entry == pack_language.end()) {
+			WhisperConfig local_config;
+			bool can_pack = ClipPack::CanPackLanguage(ResolveInputConfig(inputs[index], config, local_config));
+			entry = pack_language.emplace(input_model(index), can_pack).first;
+		}
+		return entry->second;
+	};
+
+	// Infer one decoded input, packing short clips together when whisper_pack_clips is enabled
+	auto infer = [&](ClipPack &pack, idx_t index, const std::vector<float> &pcm_data, double decode_ms) {
+		if (!config.pack_clips || !ClipPack::IsPackable(pcm_data.size()) || !can_pack_language(index)) {
+			results[index] = InferDecoded(inputs[index], pcm_data, decode_ms, config, cache_keys[index]);
+			if (!results[index].success && stop_on_error) {
+				stopped = true;
+			}
+			return;
+		}
+		if (!pack.Fits(pcm_data.size(), input_model(index))) {
+			pack.Transcribe(inputs, config, cache_keys, results);
+		}
+		pack.Add(index, pcm_data, decode_ms, input_model(index));
+	};
+
+	if (n_workers == 1) {
+		ClipPack pack;
+		for (auto i : pending) {
+			if (stopped) {
+				break;
+			}
+			std::vector<float> pcm_data;
+			double decode_ms = 0.0;
+			std::string error;
+			if (!DecodeInput(inputs[i], config, pcm_data, decode_ms, error)) {
+				fail(i, error);
+				continue;
+			}
+			infer(pack, i, pcm_data, decode_ms);
+		}
+		if (!pack.Empty()) {
+			pack.Transcribe(inputs, config, cache_keys, results);
+		}
+		return results;
+	}
+
+	DecodedAudioQueue queue(n_workers * 2, n_workers);
+	std::atomic<idx_t> next_input(0);
+
+	// Stage 1: decode and resample (an input that finds the queue full is inferred by its decoder right away)
+	auto decode_worker = [&]() {
+		ClipPack pack;
+		while (!stopped) {
+			idx_t next = next_input.fetch_add(1);
+			if (next >= pending.size()) {
+				break;
+			}
+			idx_t index = pending[next];
+			DecodedAudio item;
+			item.index = index;
+			item.decode_ms = 0.0;
+			std::string error;
+			try {
+				if (!DecodeInput(inputs[index], config, item.pcm, item.decode_ms, error)) {
+					fail(index, error);
+					continue;
+				}
+			} catch (std::exception &ex) {
+				fail(index, std::string("Failed to load audio: ") + ex.what());
+				continue;
+			}
+			if (queue.TryPush(item)) {
+				continue;
+			}
+			try {
+				infer(pack, item.index, item.pcm, item.decode_ms);
+			} catch (std::exception &ex) {
+				fail(item.index, ex.what());
+			}
+		}
+		queue.ProducerDone();
+		if (!pack.Empty()) {
+			pack.Transcribe(inputs, config, cache_keys, results);
+		}
+	};
+
+	// Stage 2: inference on pooled decoder states (each worker fills its own clip pack)
+	auto inference_worker = [&]() {
+		ClipPack pack;
+		DecodedAudio item;
+		while (queue.Pop(item)) {
+			if (stopped) {
+				continue;
+			}
+			try {
+				infer(pack, item.index, item.pcm, item.decode_ms);
+			} catch (std::exception &ex) {
+				fail(item.index, ex.what());
+			}
+			item.pcm = std::vector<float>();
+		}
+		if (!pack.Empty()) {
+			pack.Transcribe(inputs, config, cache_keys, results);
+		}
+	};
+
+	// Decoders take the lower worker indexes, so every decoder has started before an inference worker waits on it
+	WorkerPool::GetInstance().Run(n_workers * 2, [&](idx_t worker_idx) {
+		if (worker_idx < n_workers) {
+			decode_worker();
+		} else {
+			inference_worker();
+		}
+	});
+
+	return results;
+}
+
+// ============================================================================
+// Language detection
+// ============================================================================
+
+static constexpr double MAX_DETECT_SECONDS = 30.0; // The encoder only sees one 30s window
+
+static LanguageDetection DetectLanguageSamples(const float *samples, size_t n_samples, const WhisperConfig &config) {
+	LanguageDetection detection;
+	if (!samples || n_samples == 0) {
+		detection.error = "Empty audio data";
+		return detection;
+	}
+
+	double model_load_ms = 0.0;
+	auto ctx_wrapper = AcquireContext(config, model_load_ms, detection.error);
+	if (!ctx_wrapper) {
+		return detection;
+	}
+	whisper_context *ctx = ctx_wrapper->Get();
+
+	// English-only models have no language tokens to score
+	if (!whisper_is_multilingual(ctx)) {
+		detection.language = "en";
+		detection.probability = 1.0;
+		detection.success = true;
+		return detection;
+	}
+
+	std::string state_error;
+	WhisperStateLease lease(ctx_wrapper, static_cast<idx_t>(MaxValue<int>(config.max_concurrent_states, 1)),
+	                        state_error);
+	if (!lease.IsValid()) {
+		detection.error = state_error.empty() ? "Failed to allocate whisper decoder state" : state_error;
+		return detection;
+	}
+	whisper_state *wstate = lease.Get();
+	ThreadLease threads(config);
+
+	if (whisper_pcm_to_mel_with_state(ctx, wstate, samples, static_cast<int>(n_samples), threads.Threads()) != 0) {
+		detection.error = "Failed to compute mel spectrogram";
+		return detection;
+	}
+
+	// Runs the encoder over the first window, then a single decoder step that scores every language token
+	std::vector<float> lang_probs(static_cast<size_t>(whisper_lang_max_id()) + 1, 0.0f);
+	int lang_id = whisper_lang_auto_detect_with_state(ctx, wstate, 0, threads.Threads(), lang_probs.data());
+	if (lang_id < 0) {
+		detection.error = "Language detection failed with error code: " + std::to_string(lang_id);
+		return detection;
+	}
+
+	detection.language = GetLanguageCode(lang_id);
+	detection.probability = lang_probs[lang_id];
+	detection.success = true;
+	return detection;
+}
+
+static LanguageDetection DetectInputLanguage(const TranscriptionInput &input, double seconds,
+                                             const WhisperConfig &config) {
+	LanguageDetection detection;
+	WhisperConfig local_config;
+	auto &input_config = ResolveInputConfig(input, config, local_config);
+
+	// Decoding stops after the detection window, so long recordings cost no more than short ones
+	std::vector<float> pcm_data;
+	std::string load_error;
+	if (input.is_blob) {
+		if (!AudioUtils::LoadAudioFromMemoryRange(input.data, input.size, config.input_format, 0.0, seconds, pcm_data,
+		                                          load_error)) {
+			detection.error = "Failed to load audio from memory: " + load_error;
+			return detection;
+		}
+	} else if (!AudioUtils::LoadAudioFileRange(input.file_path, config.input_format, 0.0, seconds, pcm_data,
+	                                           load_error)) {
+		detection.error = "Failed to load audio: " + load_error;
+		return detection;
+	}
+	return DetectLanguageSamples(pcm_data.data(), pcm_data.size(), input_config);
+}
+
+std::vector<LanguageDetection> TranscriptionEngine::DetectLanguageBatch(const std::vector<TranscriptionInput> &inputs,
+                                                                        double seconds, const WhisperConfig &config) {
+	std::vector<LanguageDetection> detections(inputs.size());
+	if (inputs.empty()) {
+		return detections;
+	}
+	seconds = MinValue<double>(seconds, MAX_DETECT_SECONDS);
+	AudioUtils::SetFFmpegLogging(config.ffmpeg_logging);
+
+	// Each worker decodes and detects one input at a time, bounded by the decoder states available
+	idx_t max_states = static_cast<idx_t>(MaxValue<int>(config.max_concurrent_states, 1)) *
+	                   WhisperContextManager::ScheduledDeviceCount(config.use_gpu, config.gpu_device);
+	idx_t n_workers = MinValue<idx_t>(inputs.size(), max_states);
+	std::atomic<idx_t> next_input(0);
+
+	auto worker = [&]() {
+		while (true) {
+			idx_t index = next_input.fetch_add(1);
+			if (index >= inputs.size()) {
+				break;
+			}
+			try {
+				detections[index] = DetectInputLanguage(inputs[index], seconds, config);
+			} catch (std::exception &ex) {
+				detections[index].success = false;
+				detections[index].error = ex.what();
+			}
+		}
+	};
+
+	if (n_workers == 1) {
+		worker();
+		return detections;
+	}
+
+	WorkerPool::GetInstance().Run(n_workers, [&](idx_t) { worker(); });
+	return detections;
+}
+
+// ============================================================================
+// Streaming transcription
+// ============================================================================
+
+static constexpr size_t STREAM_SAMPLE_RATE = 16000;
+static constexpr size_t CUT_SEARCH_SAMPLES = STREAM_SAMPLE_RATE * 5; // Search the last 5 seconds
+
+StreamingTranscriber::StreamingTranscriber(const WhisperConfig &config)
+    : config_(config), window_start_(0), end_sample_(std::numeric_limits<size_t>::max()), next_segment_id_(0) {
+}
+
+bool StreamingTranscriber::OpenFile(const std::string &file_path, std::string &error) {
+	AudioUtils::SetFFmpegLogging(config_.ffmpeg_logging);
+	if (!reader_.OpenFile(file_path, config_.input_format, error)) {
+		error = "Failed to load audio: " + error;
+		return false;
+	}
+	SeekToRange();
+	return true;
+}
+
+bool StreamingTranscriber::OpenMemory(const uint8_t *data, size_t size, std::string &error) {
+	AudioUtils::SetFFmpegLogging(config_.ffmpeg_logging);
+	if (!reader_.OpenMemory(data, size, config_.input_format, error)) {
+		error = "Failed to load audio from memory: " + error;
+		return false;
+	}
+	SeekToRange();
+	return true;
+}
+
+void StreamingTranscriber::SeekToRange() {
+	if (config_.range_start > 0.0) {
+		reader_.Seek(config_.range_start);
+		window_start_ = static_cast<size_t>(config_.range_start * static_cast<double>(STREAM_SAMPLE_RATE));
+	}
+	if (config_.range_end >= 0.0) {
+		auto end = static_cast<size_t>(config_.range_end * static_cast<double>(STREAM_SAMPLE_RATE));
+		end_sample_ = MaxValue(end, window_start_);
+	}
+}
+
+bool StreamingTranscriber::InputDone() const {
+	return reader_.IsFinished() || window_start_ + window_.size() >= end_sample_;
+}
+
+size_t StreamingTranscriber::FindCutPoint() const {
+	size_t search = MinValue<size_t>(CUT_SEARCH_SAMPLES, window_.size() / 4);
+	if (search < QUIET_FRAME_SAMPLES) {
+		return window_.size();
+	}
+
+	// Cut in the middle of the quietest frame near the end of the window
+	return FindQuietPoint(window_.data(), window_.size() - search, window_.size());
+}
+
+bool StreamingTranscriber::Next(std::vector<TranscriptionSegment> &segments, std::string &error) {
+	size_t window_samples =
+	    static_cast<size_t>(MaxValue<double>(config_.stream_window, 1.0) * static_cast<double>(STREAM_SAMPLE_RATE));
+
+	// Top up the window; the carried-over tail of the previous window stays at the front
+	if (window_.size() < window_samples && !InputDone()) {
+		window_.reserve(window_samples);
+		size_t wanted = MinValue(window_samples - window_.size(), end_sample_ - window_start_ - window_.size());
+		if (!reader_.Read(window_, wanted, error)) {
+			return false;
+		}
+	}
+	if (window_.empty()) {
+		return false;
+	}
+
+	size_t cut = InputDone() ? window_.size() : FindCutPoint();
+
+	auto result = TranscriptionEngine::TranscribePCM(window_.data(), cut, config_);
+	if (!result.success) {
+		error = result.error;
+		return false;
+	}
+
+	profile_ = result.profile;
+	double offset = static_cast<double>(window_start_) / static_cast<double>(STREAM_SAMPLE_RATE);
+	for (auto &segment : result.segments) {
+		segment.segment_id = next_segment_id_++;
+		MapSegmentTimes(segment, [offset](double seconds, bool) { return seconds + offset; });
+		segments.push_back(std::move(segment));
+	}
+
+	window_.erase(window_.begin(), window_.begin() + cut);
+	window_start_ += cut;
+	return true;
 }
 
 } // namespace duckdb
@@ -0,0 +1,81 @@
+#include "transcription_stats.hpp"
+
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/client_context_state.hpp"
+
+namespace duckdb {
+
+static constexpr const char *LAST_PROFILE_STATE_KEY = "whisper_last_profile";
+
+// Profile of the most recent transcription of one connection, for whisper_last_profile()
+// Guarded by a mutex because parallel table functions finish inputs on several threads.
+class LastProfileContextState : public ClientContextState {
+public:
+	std::mutex mutex;
+	bool has_profile = false;
+	std::string model;
+	TranscriptionProfile profile;
+};
+
+TranscriptionStats &TranscriptionStats::GetInstance() {
+	static TranscriptionStats instance;
+	return instance;
+}
+
+ModelStats &TranscriptionStats::Entry(const std::string &model) {
+	auto &entry = models_[model];
+	entry.model = model;
+	return entry;
+}
+
+void TranscriptionStats::RecordCall(const std::string &model, const TranscriptionProfile &profile) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto &entry = Entry(model);
+	entry.calls++;
+	if (profile.cache_hit) {
+		entry.cache_hits++;
+	} else {
+		entry.audio_seconds += profile.audio_seconds;
+		entry.audio_decode_ms += profile.audio_decode_ms;
+		entry.inference_ms += profile.inference_ms;
+	}
+}
+
+void TranscriptionStats::RecordModelLoad(const std::string &model, double load_ms) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto &entry = Entry(model);
+	entry.context_loads++;
+	entry.model_load_ms += load_ms;
+}
+
+std::vector<ModelStats> TranscriptionStats::GetModelStats() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::vector<ModelStats> stats;
+	stats.reserve(models_.size());
+	for (auto &entry : models_) {
+		stats.push_back(entry.second);
+	}
+	return stats;
+}
+
+void TranscriptionStats::SetLastProfile(ClientContext &context, const std::string &model,
+                                        const TranscriptionProfile &profile) {
+	auto state = context.registered_state->GetOrCreate<LastProfileContextState>(LAST_PROFILE_STATE_KEY);
+	std::lock_guard<std::mutex> lock(state->mutex);
+	state->has_profile = true;
+	state->model = model;
+	state->profile = profile;
+}
+
+bool TranscriptionStats::GetLastProfile(ClientContext &context, std::string &model, TranscriptionProfile &profile) {
+	auto state = context.registered_state->GetOrCreate<LastProfileContextState>(LAST_PROFILE_STATE_KEY);
+	std::lock_guard<std::mutex> lock(state->mutex);
+	if (!state->has_profile) {
+		return false;
+	}
+	model = state->model;
+	profile = state->profile;
+	return true;
+}
+
+} // namespace duckdb
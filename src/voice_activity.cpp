@@ -0,0 +1,47 @@
+#include "voice_activity.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace duckdb {
+
+std::vector<SpeechSpan> VoiceActivityDetector::DetectSpeech(const float *samples, size_t n_samples,
+                                                            float threshold) {
+	std::vector<SpeechSpan> frames;
+
+	// Mark frames whose RMS amplitude exceeds the threshold, merging runs of speech frames
+	for (size_t frame = 0; frame < n_samples; frame += FRAME_SAMPLES) {
+		size_t frame_end = std::min(frame + FRAME_SAMPLES, n_samples);
+		double sum_squares = 0.0;
+		for (size_t i = frame; i < frame_end; i++) {
+			sum_squares += static_cast<double>(samples[i]) * samples[i];
+		}
+		float rms = static_cast<float>(std::sqrt(sum_squares / static_cast<double>(frame_end - frame)));
+		if (rms <= threshold) {
+			continue;
+		}
+		if (!frames.empty() && frames.back().end == frame) {
+			frames.back().end = frame_end;
+		} else {
+			frames.push_back({frame, frame_end});
+		}
+	}
+
+	// Drop isolated clicks, pad the rest and bridge pauses shorter than MIN_SILENCE_SAMPLES
+	std::vector<SpeechSpan> spans;
+	for (auto &run : frames) {
+		if (run.end - run.start < MIN_SPEECH_SAMPLES) {
+			continue;
+		}
+		size_t start = run.start > PADDING_SAMPLES ? run.start - PADDING_SAMPLES : 0;
+		size_t end = std::min(run.end + PADDING_SAMPLES, n_samples);
+		if (!spans.empty() && start <= spans.back().end + MIN_SILENCE_SAMPLES) {
+			spans.back().end = std::max(spans.back().end, end);
+		} else {
+			spans.push_back({start, end});
+		}
+	}
+	return spans;
+}
+
+} // namespace duckdb
@@ -1,21 +1,152 @@
 #ifdef WHISPER_ENABLE_VOICE_QUERY
 
-#include "duckdb.hpp"
+#include "ddl_extractor.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/database_manager.hpp"
 #include "duckdb/main/attached_database.hpp"
 #include "duckdb/catalog/catalog.hpp"
 #include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
 #include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include <algorithm>
+#include <cctype>
+#include <mutex>
 #include <string>
-#include <sstream>
+#include <unordered_map>
 
 namespace duckdb {
 
-std::string ExtractDatabaseDDL(ClientContext &context) {
+using CatalogTables = std::vector<TableDDL>;
+
+// Tables of one attached database as of a catalog version
+struct CachedCatalog {
+	std::weak_ptr<AttachedDatabase> database; // Expires once the database is detached or its instance closed
+	idx_t version;
+	std::shared_ptr<const CatalogTables> tables;
+};
+
+// Extracted tables per attached database, so repeated voice queries skip scanning unchanged catalogs
+// Keyed by the AttachedDatabase address, which cannot be reused while the entry's weak reference still points at
+// it; an expired reference means the database went away and a new one may sit at the same address. The version
+// check catches every DDL change in between.
+static std::mutex ddl_cache_mutex;
+static std::unordered_map<const AttachedDatabase *, CachedCatalog> ddl_cache;
+static constexpr idx_t MAX_CACHED_CATALOGS = 64;
+
+// Weight of a question word found in a table name relative to one found in a column name
+static constexpr idx_t TABLE_NAME_WEIGHT = 3;
+
+// Reduce a word to a form shared by its plural ("orders" and "order"); used on both sides of the match
+static std::string NormalizeWord(std::string word) {
+	if (word.size() > 3 && word.back() == 's') {
+		word.pop_back();
+	}
+	return word;
+}
+
+// Split text into lower-cased words at every non-alphanumeric character and camelCase boundary
+static void AppendWords(const std::string &text, std::vector<std::string> &words) {
+	std::string word;
+	auto flush = [&]() {
+		if (word.size() > 1) {
+			words.push_back(NormalizeWord(word));
+		}
+		word.clear();
+	};
+	for (size_t i = 0; i < text.size(); i++) {
+		unsigned char c = static_cast<unsigned char>(text[i]);
+		if (!std::isalnum(c) && c < 0x80) {
+			flush();
+			continue;
+		}
+		if (std::isupper(c) && i > 0 && std::islower(static_cast<unsigned char>(text[i - 1]))) {
+			flush();
+		}
+		word += static_cast<char>(std::tolower(c));
+	}
+	flush();
+}
+
+static void SortUnique(std::vector<std::string> &words) {
+	std::sort(words.begin(), words.end());
+	words.erase(std::unique(words.begin(), words.end()), words.end());
+}
+
+static std::shared_ptr<const CatalogTables> ScanCatalogTables(ClientContext &context, Catalog &catalog) {
+	auto tables = std::make_shared<CatalogTables>();
+
+	auto schemas = catalog.GetSchemas(context);
+	for (auto &schema_ref : schemas) {
+		auto &schema = schema_ref.get();
+
+		// Skip internal schemas
+		if (schema.name == "pg_catalog" || schema.name == "information_schema") {
+			continue;
+		}
+
+		// Scan all tables in this schema
+		schema.Scan(context, CatalogType::TABLE_ENTRY, [&](CatalogEntry &entry) {
+			if (entry.type == CatalogType::TABLE_ENTRY) {
+				auto &table = entry.Cast<TableCatalogEntry>();
+				// Skip internal tables
+				if (table.internal) {
+					return;
+				}
+
+				TableDDL ddl;
+				ddl.sql = table.ToSQL();
+				if (ddl.sql.empty()) {
+					return;
+				}
+				AppendWords(table.name, ddl.name_words);
+				for (auto &column : table.GetColumns().Logical()) {
+					AppendWords(column.Name(), ddl.column_words);
+				}
+				SortUnique(ddl.name_words);
+				SortUnique(ddl.column_words);
+				tables->push_back(std::move(ddl));
+			}
+		});
+	}
+	return tables;
+}
+
+static std::shared_ptr<const CatalogTables> GetCatalogTables(ClientContext &context,
+                                                             const shared_ptr<AttachedDatabase> &database) {
+	auto &catalog = database->GetCatalog();
+
+	// Catalogs that do not track versions (e.g. some attached non-DuckDB databases) are always scanned
+	auto version = catalog.GetCatalogVersion(context);
+	if (!version.IsValid()) {
+		return ScanCatalogTables(context, catalog);
+	}
+
+	const AttachedDatabase *key = database.get();
+	{
+		std::lock_guard<std::mutex> lock(ddl_cache_mutex);
+		auto entry = ddl_cache.find(key);
+		if (entry != ddl_cache.end() && entry->second.database.lock() == database &&
+		    entry->second.version == version.GetIndex()) {
+			return entry->second.tables;
+		}
+	}
+
+	auto tables = ScanCatalogTables(context, catalog);
+
+	std::lock_guard<std::mutex> lock(ddl_cache_mutex);
+	// Drop entries of databases that are gone before falling back to starting over
+	for (auto it = ddl_cache.begin(); it != ddl_cache.end();) {
+		it = it->second.database.expired() ? ddl_cache.erase(it) : std::next(it);
+	}
+	if (ddl_cache.size() >= MAX_CACHED_CATALOGS && ddl_cache.find(key) == ddl_cache.end()) {
+		ddl_cache.clear();
+	}
+	ddl_cache[key] = CachedCatalog {database, version.GetIndex(), tables};
+	return tables;
+}
+
+DatabaseSchema ExtractDatabaseSchema(ClientContext &context) {
 	// Use catalog API directly instead of running a query (avoids deadlock in bind phase)
-	std::ostringstream ddl_stream;
-	bool first = true;
+	DatabaseSchema schema;
 
 	try {
 		// Get all attached databases
@@ -27,45 +158,70 @@ std::string ExtractDatabaseDDL(ClientContext &context) {
 			if (db->IsSystem()) {
 				continue;
 			}
+			schema.catalogs.push_back(GetCatalogTables(context, db));
+		}
+	} catch (...) {
+		// Return an empty schema on error
+		return DatabaseSchema();
+	}
+
+	return schema;
+}
 
-			auto &catalog = db->GetCatalog();
-			auto schemas = catalog.GetSchemas(context);
+static idx_t CountMatches(const std::vector<std::string> &question_words, const std::vector<std::string> &words) {
+	idx_t matches = 0;
+	for (auto &word : question_words) {
+		if (std::binary_search(words.begin(), words.end(), word)) {
+			matches++;
+		}
+	}
+	return matches;
+}
 
-			for (auto &schema_ref : schemas) {
-				auto &schema = schema_ref.get();
+std::string DatabaseSchema::ToDDL(const std::string &question, idx_t max_tables) const {
+	std::vector<const TableDDL *> tables;
+	for (auto &catalog : catalogs) {
+		for (auto &table : *catalog) {
+			tables.push_back(&table);
+		}
+	}
 
-				// Skip internal schemas
-				if (schema.name == "pg_catalog" || schema.name == "information_schema") {
-					continue;
-				}
+	if (max_tables > 0 && tables.size() > max_tables) {
+		std::vector<std::string> question_words;
+		AppendWords(question, question_words);
+		SortUnique(question_words);
 
-				// Scan all tables in this schema
-				schema.Scan(context, CatalogType::TABLE_ENTRY, [&](CatalogEntry &entry) {
-					if (entry.type == CatalogType::TABLE_ENTRY) {
-						auto &table = entry.Cast<TableCatalogEntry>();
-						// Skip internal tables
-						if (table.internal) {
-							return;
-						}
-
-						std::string sql = table.ToSQL();
-						if (!sql.empty()) {
-							if (!first) {
-								ddl_stream << "; ";
-							}
-							ddl_stream << sql;
-							first = false;
-						}
-					}
-				});
-			}
+		std::vector<idx_t> scores;
+		scores.reserve(tables.size());
+		for (auto table : tables) {
+			scores.push_back(TABLE_NAME_WEIGHT * CountMatches(question_words, table->name_words) +
+			                 CountMatches(question_words, table->column_words));
 		}
-	} catch (...) {
-		// Return empty string on error
-		return "";
+
+		// Keep the best-scoring tables; without any match this keeps the first ones in catalog order
+		std::vector<idx_t> order(tables.size());
+		for (idx_t i = 0; i < order.size(); i++) {
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [&](idx_t a, idx_t b) { return scores[a] > scores[b]; });
+		order.resize(max_tables);
+		std::sort(order.begin(), order.end());
+
+		std::vector<const TableDDL *> selected;
+		for (auto index : order) {
+			selected.push_back(tables[index]);
+		}
+		tables = std::move(selected);
 	}
 
-	return ddl_stream.str();
+	std::string ddl;
+	for (auto table : tables) {
+		if (!ddl.empty()) {
+			ddl += "; ";
+		}
+		ddl += table->sql;
+	}
+	return ddl;
 }
 
 } // namespace duckdb
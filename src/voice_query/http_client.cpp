@@ -5,9 +5,78 @@
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <mutex>
+#include <vector>
+
+#ifdef WHISPER_HTTP_GZIP
+#include <zlib.h>
+#endif
 
 namespace duckdb {
 
+// Idle curl handles shared by all HttpClient instances in the process
+class CurlHandlePool {
+public:
+	static CurlHandlePool &Get() {
+		static CurlHandlePool instance;
+		return instance;
+	}
+
+	CURL *Acquire() {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (idle.empty()) {
+			return curl_easy_init();
+		}
+		CURL *handle = idle.back();
+		idle.pop_back();
+		return handle;
+	}
+
+	void Release(CURL *handle) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (idle.size() < MAX_IDLE_HANDLES) {
+			idle.push_back(handle);
+			return;
+		}
+		curl_easy_cleanup(handle);
+	}
+
+	~CurlHandlePool() {
+		for (auto handle : idle) {
+			curl_easy_cleanup(handle);
+		}
+	}
+
+private:
+	// Enough for a few concurrent voice queries; extra handles are closed when released
+	static constexpr size_t MAX_IDLE_HANDLES = 4;
+
+	std::mutex mutex;
+	std::vector<CURL *> idle;
+};
+
+#ifdef WHISPER_HTTP_GZIP
+// Bodies smaller than this are sent as-is; compressing them saves less than it costs
+static constexpr size_t MIN_COMPRESS_BYTES = 1024;
+
+static bool GzipCompress(const std::string &input, std::string &output) {
+	z_stream stream = {};
+	// 15 window bits + 16 selects the gzip wrapper instead of zlib's
+	if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		return false;
+	}
+	output.resize(deflateBound(&stream, static_cast<uLong>(input.size())));
+	stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(input.data()));
+	stream.avail_in = static_cast<uInt>(input.size());
+	stream.next_out = reinterpret_cast<Bytef *>(&output[0]);
+	stream.avail_out = static_cast<uInt>(output.size());
+	int result = deflate(&stream, Z_FINISH);
+	output.resize(stream.total_out);
+	deflateEnd(&stream);
+	return result == Z_STREAM_END;
+}
+#endif
+
 // Callback for libcurl to write response data
 static size_t WriteCallback(void *contents, size_t size, size_t nmemb, void *userp) {
 	size_t total_size = size * nmemb;
@@ -17,17 +86,62 @@ static size_t WriteCallback(void *contents, size_t size, size_t nmemb, void *use
 }
 
 HttpClient::HttpClient() : curl_handle(nullptr) {
-	curl_handle = curl_easy_init();
+	curl_handle = CurlHandlePool::Get().Acquire();
 }
 
 HttpClient::~HttpClient() {
 	if (curl_handle) {
-		curl_easy_cleanup(static_cast<CURL *>(curl_handle));
+		CurlHandlePool::Get().Release(static_cast<CURL *>(curl_handle));
 		curl_handle = nullptr;
 	}
 }
 
-HttpResponse HttpClient::Post(const std::string &url, const std::string &json_body, int32_t timeout_seconds) {
+void HttpClient::SetCommonOptions(const std::string &url, int32_t timeout_seconds) {
+	CURL *curl = static_cast<CURL *>(curl_handle);
+
+	// Reset options left by the previous request (keeps open connections, the DNS cache and TLS sessions)
+	curl_easy_reset(curl);
+
+	// Set URL
+	curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+
+	// Set timeout (total operation) and connect timeout (just for reaching the server)
+	curl_easy_setopt(curl, CURLOPT_TIMEOUT, static_cast<long>(timeout_seconds));
+	curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 3L);
+
+	// Required for multi-threaded environments - don't use signals for timeout
+	curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+	// Force IPv4 to avoid potential IPv6 issues with localhost
+	curl_easy_setopt(curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V4);
+
+	// Follow redirects
+	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+
+	// Negotiate HTTP/2 over TLS (plain http stays on HTTP/1.1) and keep idle connections alive
+	curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+	curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+
+	// Accept any response encoding curl can decode
+	curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+}
+
+void HttpClient::Warmup(const std::string &url) {
+	if (!curl_handle) {
+		return;
+	}
+
+	CURL *curl = static_cast<CURL *>(curl_handle);
+	SetCommonOptions(url, 3);
+
+	// A HEAD request leaves a kept-alive connection in the handle's cache (CURLOPT_CONNECT_ONLY
+	// connections are not reused for later transfers); the status code does not matter
+	curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+	curl_easy_perform(curl);
+}
+
+HttpResponse HttpClient::Post(const std::string &url, const std::string &json_body, int32_t timeout_seconds,
+                              bool compress) {
 	HttpResponse response;
 
 	if (!curl_handle) {
@@ -38,39 +152,38 @@ HttpResponse HttpClient::Post(const std::string &url, const std::string &json_bo
 	CURL *curl = static_cast<CURL *>(curl_handle);
 	std::string response_body;
 
-	// Reset curl handle for reuse
-	curl_easy_reset(curl);
+	SetCommonOptions(url, timeout_seconds);
 
-	// Set URL
-	curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+	// Large schemas make for request bodies of hundreds of KB, which compress well
+	const std::string *body = &json_body;
+	bool compressed = false;
+#ifdef WHISPER_HTTP_GZIP
+	std::string compressed_body;
+	if (compress && json_body.size() >= MIN_COMPRESS_BYTES && GzipCompress(json_body, compressed_body)) {
+		body = &compressed_body;
+		compressed = true;
+	}
+#else
+	(void)compress;
+#endif
 
 	// Set POST data
-	curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_body.c_str());
-	curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(json_body.size()));
+	curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body->c_str());
+	curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(body->size()));
 
 	// Set headers
 	struct curl_slist *headers = nullptr;
 	headers = curl_slist_append(headers, "Content-Type: application/json");
 	headers = curl_slist_append(headers, "Accept: application/json");
+	if (compressed) {
+		headers = curl_slist_append(headers, "Content-Encoding: gzip");
+	}
 	curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
 
 	// Set response callback
 	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
 	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_body);
 
-	// Set timeout (total operation) and connect timeout (just for reaching the server)
-	curl_easy_setopt(curl, CURLOPT_TIMEOUT, static_cast<long>(timeout_seconds));
-	curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 3L);
-
-	// Required for multi-threaded environments - don't use signals for timeout
-	curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
-
-	// Force IPv4 to avoid potential IPv6 issues with localhost
-	curl_easy_setopt(curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V4);
-
-	// Follow redirects
-	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-
 	// Perform request
 	CURLcode res = curl_easy_perform(curl);
 
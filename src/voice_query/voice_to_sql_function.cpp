@@ -7,58 +7,55 @@
 #include "duckdb/common/string_util.hpp"
 
 #include "whisper_config.hpp"
-#include "audio_recorder.hpp"
+#include "live_transcriber.hpp"
 #include "transcription_engine.hpp"
+#include "transcription_stats.hpp"
 #include "http_client.hpp"
+#include "ddl_extractor.hpp"
 
 #include <future>
 #include <chrono>
 
 namespace duckdb {
 
-// Forward declaration from ddl_extractor.cpp
-std::string ExtractDatabaseDDL(ClientContext &context);
-
 // ============================================================================
 // Helper function to perform voice-to-sql operation
 // ============================================================================
 
-static std::string PerformVoiceToSql(const WhisperConfig &config, int device_id, const std::string &ddl) {
-	// Step 1: Record audio until silence
-	AudioRecorder recorder;
+static std::string PerformVoiceToSql(const WhisperConfig &config, int device_id,
+                                     std::shared_future<DatabaseSchema> schema, TranscriptionProfile &out_profile) {
+	// Open the connection to the proxy (DNS, TCP and TLS) while the user is speaking
+	auto warm_client = std::async(std::launch::async, [&config]() {
+		auto client = make_uniq<HttpClient>();
+		client->Warmup(config.text_to_sql_url);
+		return client;
+	});
+
+	// Step 1: Record audio until silence, transcribing while recording
+	// Settled speech is transcribed during the recording, so only the last few seconds remain after it stops.
+	LiveTranscriber live(config, LiveTranscriber::DEFAULT_STEP_SECONDS);
 	std::string error;
-	std::vector<float> pcm_data;
 
 	if (config.verbose) {
 		Printer::Print(OutputStream::STREAM_STDERR, "Listening...");
 	}
 
 	// Record with automatic silence detection using configured values
-	if (!recorder.RecordUntilSilence(pcm_data, config.max_duration, config.silence_duration,
-	                                 static_cast<float>(config.silence_threshold), device_id, error)) {
+	if (!live.Start(device_id, config.max_duration, config.silence_duration, error)) {
 		throw InvalidInputException("Failed to record audio: " + error);
 	}
 
-	if (config.verbose) {
-		Printer::Print(OutputStream::STREAM_STDERR, "Stopped");
-	}
-
-	if (pcm_data.empty()) {
-		throw InvalidInputException("No speech detected. Please try again.");
-	}
-
 	// Step 2: Transcribe the audio
-	if (config.verbose) {
-		Printer::Print(OutputStream::STREAM_STDERR, "Transcribing...");
+	std::string question;
+	if (!live.TranscribeUntilStopped(question, error)) {
+		throw InvalidInputException("Transcription failed: " + error);
 	}
+	out_profile = live.Profile();
 
-	TranscriptionResult transcription = TranscriptionEngine::TranscribePCM(pcm_data, config);
-
-	if (!transcription.success) {
-		throw InvalidInputException("Transcription failed: " + transcription.error);
+	if (config.verbose) {
+		Printer::Print(OutputStream::STREAM_STDERR, "Stopped");
 	}
 
-	std::string question = transcription.full_text;
 	if (question.empty()) {
 		throw InvalidInputException("No speech detected. Please try again.");
 	}
@@ -69,15 +66,19 @@ static std::string PerformVoiceToSql(const WhisperConfig &config, int device_id,
 		Printer::Print(OutputStream::STREAM_STDERR, "Transcribed: '" + trimmed_question + "'");
 	}
 
-	// Step 3: Call text-to-sql proxy (DDL already extracted on main thread)
-	HttpClient client;
+	// Step 3: Call text-to-sql proxy (the schema is read on the calling thread during the recording)
+	// With whisper_voice_query_max_tables set, only the tables matching the question are sent.
+	auto client = warm_client.get();
+	auto max_tables = static_cast<idx_t>(MaxValue(config.voice_query_max_tables, 0));
+	std::string ddl = schema.get().ToDDL(question, max_tables);
 	std::string json_body = BuildJsonRequest(ddl, question);
 
 	if (config.verbose) {
 		Printer::Print(OutputStream::STREAM_STDERR, "Text-to-SQL request sent...");
 	}
 
-	HttpResponse response = client.Post(config.text_to_sql_url, json_body, config.text_to_sql_timeout);
+	HttpResponse response =
+	    client->Post(config.text_to_sql_url, json_body, config.text_to_sql_timeout, config.text_to_sql_compress);
 
 	if (config.verbose) {
 		Printer::Print(OutputStream::STREAM_STDERR, "Text-to-SQL response received");
@@ -102,31 +103,39 @@ static std::string PerformVoiceToSql(const WhisperConfig &config, int device_id,
 // ============================================================================
 
 static std::string PerformVoiceToSqlWithTimeout(ClientContext &context, const WhisperConfig &config, int device_id) {
-	// Extract DDL on main thread first (ClientContext is not thread-safe)
-	if (config.verbose) {
-		Printer::Print(OutputStream::STREAM_STDERR, "Reading schema...");
-	}
-
-	std::string ddl = ExtractDatabaseDDL(context);
-
-	if (config.verbose) {
-		Printer::Print(OutputStream::STREAM_STDERR, "Schema read");
-	}
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(config.voice_query_timeout);
 
 	// Use std::async to run the rest of the operation with a timeout
 	std::string result_sql;
+	TranscriptionProfile result_profile;
 	std::exception_ptr exception_ptr = nullptr;
 
-	auto future = std::async(std::launch::async, [&]() {
+	// Declared before the promise so a throw below breaks the promise before the future's destructor waits
+	std::future<void> future;
+	std::promise<DatabaseSchema> schema_promise;
+	std::shared_future<DatabaseSchema> schema = schema_promise.get_future().share();
+
+	// Recording and transcription do not need the ClientContext, so they start right away
+	future = std::async(std::launch::async, [&, schema]() {
 		try {
-			result_sql = PerformVoiceToSql(config, device_id, ddl);
+			result_sql = PerformVoiceToSql(config, device_id, schema, result_profile);
 		} catch (...) {
 			exception_ptr = std::current_exception();
 		}
 	});
 
-	auto timeout = std::chrono::seconds(config.voice_query_timeout);
-	if (future.wait_for(timeout) == std::future_status::timeout) {
+	// Extract DDL on the calling thread meanwhile (ClientContext is not thread-safe)
+	if (config.verbose) {
+		Printer::Print(OutputStream::STREAM_STDERR, "Reading schema...");
+	}
+
+	schema_promise.set_value(ExtractDatabaseSchema(context));
+
+	if (config.verbose) {
+		Printer::Print(OutputStream::STREAM_STDERR, "Schema read");
+	}
+
+	if (future.wait_until(deadline) == std::future_status::timeout) {
 		throw InvalidInputException("Voice query timed out after " + std::to_string(config.voice_query_timeout) +
 		                            " seconds. Increase whisper_voice_query_timeout if needed.");
 	}
@@ -137,6 +146,8 @@ static std::string PerformVoiceToSqlWithTimeout(ClientContext &context, const Wh
 		std::rethrow_exception(exception_ptr);
 	}
 
+	// Set on the calling thread, which owns the ClientContext
+	TranscriptionStats::SetLastProfile(context, config.model, result_profile);
 	return result_sql;
 }
 
@@ -0,0 +1,132 @@
+#include "wav_reader.hpp"
+#include "mapped_file.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WAV_READER_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define WAV_READER_NEON 1
+#endif
+
+namespace duckdb {
+
+static constexpr uint32_t WHISPER_SAMPLE_RATE = 16000;
+
+static constexpr uint16_t WAVE_FORMAT_PCM = 0x0001;
+static constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+static constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+// Same scale FFmpeg uses for s16 -> flt conversion, so both paths produce identical samples
+static constexpr float INT16_SCALE = 1.0f / 32768.0f;
+
+static uint16_t ReadLE16(const uint8_t *p) {
+	return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t ReadLE32(const uint8_t *p) {
+	return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+	       (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void WavReader::ConvertInt16(const uint8_t *input, size_t n_samples, float *output) {
+	size_t i = 0;
+#if WAV_READER_SSE2
+	const __m128 scale = _mm_set1_ps(INT16_SCALE);
+	for (; i + 8 <= n_samples; i += 8) {
+		__m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i * 2));
+		// Sign-extend int16 -> int32 by placing each sample in the high half and shifting back down
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+		_mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+		_mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+	}
+#elif WAV_READER_NEON
+	const float32x4_t scale = vdupq_n_f32(INT16_SCALE);
+	for (; i + 8 <= n_samples; i += 8) {
+		int16x8_t samples = vreinterpretq_s16_u8(vld1q_u8(input + i * 2));
+		int32x4_t lo = vmovl_s16(vget_low_s16(samples));
+		int32x4_t hi = vmovl_s16(vget_high_s16(samples));
+		vst1q_f32(output + i, vmulq_f32(vcvtq_f32_s32(lo), scale));
+		vst1q_f32(output + i + 4, vmulq_f32(vcvtq_f32_s32(hi), scale));
+	}
+#endif
+	for (; i < n_samples; i++) {
+		output[i] = static_cast<float>(static_cast<int16_t>(ReadLE16(input + i * 2))) * INT16_SCALE;
+	}
+}
+
+bool WavReader::LoadMemory(const uint8_t *data, size_t size, std::vector<float> &output) {
+	if (!data || size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+		return false;
+	}
+
+	uint16_t format_tag = 0;
+	uint16_t channels = 0;
+	uint32_t sample_rate = 0;
+	uint16_t bits_per_sample = 0;
+	bool have_fmt = false;
+
+	// Walk the chunk list up to the data chunk (chunks are padded to even sizes)
+	size_t pos = 12;
+	while (pos + 8 <= size) {
+		const uint8_t *chunk = data + pos;
+		size_t chunk_size = ReadLE32(chunk + 4);
+		size_t body = pos + 8;
+
+		if (memcmp(chunk, "fmt ", 4) == 0) {
+			if (chunk_size < 16 || body + chunk_size > size) {
+				return false;
+			}
+			format_tag = ReadLE16(data + body);
+			channels = ReadLE16(data + body + 2);
+			sample_rate = ReadLE32(data + body + 4);
+			bits_per_sample = ReadLE16(data + body + 14);
+			if (format_tag == WAVE_FORMAT_EXTENSIBLE) {
+				// The sub-format GUID starts with the actual format tag
+				if (chunk_size < 40) {
+					return false;
+				}
+				format_tag = ReadLE16(data + body + 24);
+			}
+			have_fmt = true;
+		} else if (memcmp(chunk, "data", 4) == 0) {
+			if (!have_fmt || channels != 1 || sample_rate != WHISPER_SAMPLE_RATE) {
+				return false;
+			}
+
+			// Streaming writers may leave the size unset; clamp to what is actually present
+			size_t data_size = chunk_size < size - body ? chunk_size : size - body;
+			const uint8_t *samples = data + body;
+
+			if (format_tag == WAVE_FORMAT_PCM && bits_per_sample == 16) {
+				size_t n_samples = data_size / 2;
+				output.resize(n_samples);
+				ConvertInt16(samples, n_samples, output.data());
+				return true;
+			}
+			if (format_tag == WAVE_FORMAT_IEEE_FLOAT && bits_per_sample == 32) {
+				size_t n_samples = data_size / 4;
+				output.resize(n_samples);
+				memcpy(output.data(), samples, n_samples * sizeof(float));
+				return true;
+			}
+			return false;
+		}
+
+		pos = body + chunk_size + (chunk_size & 1);
+	}
+	return false;
+}
+
+bool WavReader::LoadFile(const std::string &file_path, std::vector<float> &output) {
+	MappedFile file(file_path);
+	if (!file.Data()) {
+		return false;
+	}
+	return LoadMemory(file.Data(), file.Size(), output);
+}
+
+} // namespace duckdb
@@ -2,6 +2,8 @@
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/database.hpp"
 #include "duckdb/main/config.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 
 #include <cstdlib>
 
@@ -17,12 +19,23 @@ namespace duckdb {
 
 WhisperConfig::WhisperConfig()
     : model(DEFAULT_MODEL), model_path(GetDefaultModelPath()), language(DEFAULT_LANGUAGE), threads(DEFAULT_THREADS),
-      timestamps(DEFAULT_TIMESTAMPS), max_segment_length(DEFAULT_MAX_SEGMENT_LENGTH), translate(DEFAULT_TRANSLATE),
-      device_id(DEFAULT_DEVICE_ID), max_duration(DEFAULT_MAX_DURATION), silence_duration(DEFAULT_SILENCE_DURATION),
-      silence_threshold(DEFAULT_SILENCE_THRESHOLD), text_to_sql_url(DEFAULT_TEXT_TO_SQL_URL),
-      text_to_sql_timeout(DEFAULT_TEXT_TO_SQL_TIMEOUT), voice_query_show_sql(DEFAULT_VOICE_QUERY_SHOW_SQL),
-      voice_query_timeout(DEFAULT_VOICE_QUERY_TIMEOUT), verbose(DEFAULT_VERBOSE),
-      ffmpeg_logging(DEFAULT_FFMPEG_LOGGING), use_gpu(DEFAULT_USE_GPU) {
+      threads_policy(DEFAULT_THREADS_POLICY), scheduler_threads(0), timestamps(DEFAULT_TIMESTAMPS),
+      max_segment_length(DEFAULT_MAX_SEGMENT_LENGTH), translate(DEFAULT_TRANSLATE),
+      max_concurrent_states(DEFAULT_MAX_CONCURRENT_STATES), model_cache_mb(DEFAULT_MODEL_CACHE_MB),
+      streaming(DEFAULT_STREAMING), stream_window(DEFAULT_STREAM_WINDOW), parallel_chunks(DEFAULT_PARALLEL_CHUNKS),
+      pack_clips(DEFAULT_PACK_CLIPS), cache(DEFAULT_CACHE), cache_size(DEFAULT_CACHE_SIZE),
+      cache_persist(DEFAULT_CACHE_PERSIST), cache_disk_mb(DEFAULT_CACHE_DISK_MB), input_format(DEFAULT_INPUT_FORMAT),
+      vad(DEFAULT_VAD), vad_threshold(DEFAULT_VAD_THRESHOLD), beam_size(DEFAULT_BEAM_SIZE), best_of(DEFAULT_BEST_OF),
+      temperature(DEFAULT_TEMPERATURE), temperature_inc(DEFAULT_TEMPERATURE_INC), entropy_thold(DEFAULT_ENTROPY_THOLD),
+      no_context(DEFAULT_NO_CONTEXT), audio_ctx(DEFAULT_AUDIO_CTX), flash_attn(DEFAULT_FLASH_ATTN),
+      collect_tokens(false), token_timestamps(false), segment_confidence(true), range_start(0.0), range_end(-1.0),
+      concurrent_runs(1), device_id(DEFAULT_DEVICE_ID), max_duration(DEFAULT_MAX_DURATION),
+      silence_duration(DEFAULT_SILENCE_DURATION), silence_threshold(DEFAULT_SILENCE_THRESHOLD),
+      text_to_sql_url(DEFAULT_TEXT_TO_SQL_URL), text_to_sql_timeout(DEFAULT_TEXT_TO_SQL_TIMEOUT),
+      text_to_sql_compress(DEFAULT_TEXT_TO_SQL_COMPRESS), voice_query_show_sql(DEFAULT_VOICE_QUERY_SHOW_SQL),
+      voice_query_timeout(DEFAULT_VOICE_QUERY_TIMEOUT), voice_query_max_tables(DEFAULT_VOICE_QUERY_MAX_TABLES),
+      verbose(DEFAULT_VERBOSE), ffmpeg_logging(DEFAULT_FFMPEG_LOGGING), use_gpu(DEFAULT_USE_GPU),
+      gpu_device(DEFAULT_GPU_DEVICE) {
 }
 
 std::string WhisperConfig::GetDefaultModelPath() {
@@ -47,6 +60,16 @@ std::string WhisperConfig::GetDefaultModelPath() {
 #endif
 }
 
+// Reject unknown thread policies when they are set instead of at the next transcription
+static void SetThreadsPolicy(ClientContext &context, SetScope scope, Value &parameter) {
+	auto policy = StringUtil::Lower(parameter.ToString());
+	if (policy != "auto" && policy != "per_call" && policy != "shared") {
+		throw InvalidInputException("Invalid whisper_threads_policy '%s' (expected 'auto', 'per_call' or 'shared')",
+		                            parameter.ToString());
+	}
+	parameter = Value(policy);
+}
+
 void WhisperConfigManager::RegisterSettings(DatabaseInstance &db) {
 	auto &config = DBConfig::GetConfig(db);
 
@@ -63,6 +86,89 @@ void WhisperConfigManager::RegisterSettings(DatabaseInstance &db) {
 	config.AddExtensionOption("whisper_threads", "Number of processing threads (0 = auto-detect)", LogicalType::INTEGER,
 	                          Value::INTEGER(WhisperConfig::DEFAULT_THREADS));
 
+	config.AddExtensionOption("whisper_threads_policy",
+	                          "How threads are shared by concurrent transcriptions: auto, per_call or shared",
+	                          LogicalType::VARCHAR, Value(WhisperConfig::DEFAULT_THREADS_POLICY), SetThreadsPolicy);
+
+	config.AddExtensionOption("whisper_max_concurrent_states",
+	                          "Maximum concurrent transcriptions sharing one loaded model (decoder states)",
+	                          LogicalType::INTEGER, Value::INTEGER(WhisperConfig::DEFAULT_MAX_CONCURRENT_STATES));
+
+	config.AddExtensionOption("whisper_model_cache_mb",
+	                          "Memory budget in MB for loaded models, unloading least recently used (0 = unlimited)",
+	                          LogicalType::INTEGER, Value::INTEGER(WhisperConfig::DEFAULT_MODEL_CACHE_MB));
+
+	config.AddExtensionOption("whisper_streaming",
+	                          "Decode and transcribe files in windows in whisper_transcribe_segments (bounded memory)",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(WhisperConfig::DEFAULT_STREAMING));
+
+	config.AddExtensionOption("whisper_stream_window", "Window length in seconds when whisper_streaming is enabled",
+	                          LogicalType::DOUBLE, Value::DOUBLE(WhisperConfig::DEFAULT_STREAM_WINDOW));
+
+	config.AddExtensionOption("whisper_parallel_chunks",
+	                          "Split long audio at quiet points into N chunks transcribed in parallel (1 = off)",
+	                          LogicalType::INTEGER, Value::INTEGER(WhisperConfig::DEFAULT_PARALLEL_CHUNKS));
+
+	config.AddExtensionOption("whisper_pack_clips",
+	                          "Transcribe short clips of a whisper_transcribe batch together in shared 30s windows",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(WhisperConfig::DEFAULT_PACK_CLIPS));
+
+	config.AddExtensionOption("whisper_cache",
+	                          "Cache transcription results keyed by audio content and decode parameters",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(WhisperConfig::DEFAULT_CACHE));
+
+	config.AddExtensionOption("whisper_cache_size",
+	                          "Maximum number of transcription results kept in the in-memory cache",
+	                          LogicalType::INTEGER, Value::INTEGER(WhisperConfig::DEFAULT_CACHE_SIZE));
+
+	config.AddExtensionOption("whisper_cache_persist", "Persist cached transcriptions to disk under whisper_model_path",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(WhisperConfig::DEFAULT_CACHE_PERSIST));
+
+	config.AddExtensionOption("whisper_cache_disk_mb",
+	                          "Size limit in MB of transcriptions persisted by whisper_cache_persist (0 = unlimited)",
+	                          LogicalType::INTEGER, Value::INTEGER(WhisperConfig::DEFAULT_CACHE_DISK_MB));
+
+	config.AddExtensionOption("whisper_input_format",
+	                          "Container format hint (e.g. 'wav') that skips format probing (empty = auto-detect)",
+	                          LogicalType::VARCHAR, Value(WhisperConfig::DEFAULT_INPUT_FORMAT));
+
+	config.AddExtensionOption("whisper_vad", "Detect speech and only transcribe speech regions (skips silence)",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(WhisperConfig::DEFAULT_VAD));
+
+	config.AddExtensionOption("whisper_vad_threshold",
+	                          "RMS amplitude above which audio counts as speech when whisper_vad is enabled",
+	                          LogicalType::DOUBLE, Value::DOUBLE(WhisperConfig::DEFAULT_VAD_THRESHOLD));
+
+	config.AddExtensionOption("whisper_beam_size", "Beam search width; 1 uses greedy decoding (fastest)",
+	                          LogicalType::INTEGER, Value::INTEGER(WhisperConfig::DEFAULT_BEAM_SIZE));
+
+	config.AddExtensionOption("whisper_best_of",
+	                          "Candidates sampled per window during temperature fallback (greedy decoding)",
+	                          LogicalType::INTEGER, Value::INTEGER(WhisperConfig::DEFAULT_BEST_OF));
+
+	config.AddExtensionOption("whisper_temperature", "Initial sampling temperature (0 = deterministic)",
+	                          LogicalType::DOUBLE, Value::DOUBLE(WhisperConfig::DEFAULT_TEMPERATURE));
+
+	config.AddExtensionOption("whisper_temperature_inc",
+	                          "Temperature increase for fallback decodes of failed windows (0 disables fallback)",
+	                          LogicalType::DOUBLE, Value::DOUBLE(WhisperConfig::DEFAULT_TEMPERATURE_INC));
+
+	config.AddExtensionOption("whisper_entropy_thold",
+	                          "Token entropy above which a window is decoded again at a higher temperature",
+	                          LogicalType::DOUBLE, Value::DOUBLE(WhisperConfig::DEFAULT_ENTROPY_THOLD));
+
+	config.AddExtensionOption("whisper_no_context",
+	                          "Do not use previously decoded text as a prompt for the next 30 second window",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(WhisperConfig::DEFAULT_NO_CONTEXT));
+
+	config.AddExtensionOption("whisper_audio_ctx",
+	                          "Encoder context in frames (0 = full 30 seconds; smaller is faster for short clips)",
+	                          LogicalType::INTEGER, Value::INTEGER(WhisperConfig::DEFAULT_AUDIO_CTX));
+
+	config.AddExtensionOption("whisper_flash_attn",
+	                          "Use flash attention when loading models (faster, especially on GPU)",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(WhisperConfig::DEFAULT_FLASH_ATTN));
+
 	// Recording settings
 	config.AddExtensionOption("whisper_device_id", "Audio input device ID (-1 = system default)", LogicalType::INTEGER,
 	                          Value::INTEGER(WhisperConfig::DEFAULT_DEVICE_ID));
@@ -82,9 +188,14 @@ void WhisperConfigManager::RegisterSettings(DatabaseInstance &db) {
 	config.AddExtensionOption("whisper_ffmpeg_logging", "Enable FFmpeg log output (warnings, info messages)",
 	                          LogicalType::BOOLEAN, Value::BOOLEAN(WhisperConfig::DEFAULT_FFMPEG_LOGGING));
 
-	config.AddExtensionOption("whisper_use_gpu", "Use GPU acceleration if available (Metal on macOS)",
+	config.AddExtensionOption("whisper_use_gpu",
+	                          "Use GPU acceleration if available (Metal on macOS, CUDA or Vulkan when built with them)",
 	                          LogicalType::BOOLEAN, Value::BOOLEAN(WhisperConfig::DEFAULT_USE_GPU));
 
+	config.AddExtensionOption("whisper_gpu_device",
+	                          "GPU device to run inference on (-1 = spread concurrent transcriptions across all GPUs)",
+	                          LogicalType::INTEGER, Value::INTEGER(WhisperConfig::DEFAULT_GPU_DEVICE));
+
 #ifdef WHISPER_ENABLE_VOICE_QUERY
 	// Voice query settings
 	config.AddExtensionOption("whisper_text_to_sql_url", "URL of the text-to-sql proxy service", LogicalType::VARCHAR,
@@ -93,11 +204,19 @@ void WhisperConfigManager::RegisterSettings(DatabaseInstance &db) {
 	config.AddExtensionOption("whisper_text_to_sql_timeout", "Timeout for text-to-sql proxy requests (seconds)",
 	                          LogicalType::INTEGER, Value::INTEGER(WhisperConfig::DEFAULT_TEXT_TO_SQL_TIMEOUT));
 
+	config.AddExtensionOption("whisper_text_to_sql_compress",
+	                          "Gzip-compress text-to-sql request bodies (proxy must accept Content-Encoding: gzip)",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(WhisperConfig::DEFAULT_TEXT_TO_SQL_COMPRESS));
+
 	config.AddExtensionOption("whisper_voice_query_show_sql", "Show generated SQL in voice query output",
 	                          LogicalType::BOOLEAN, Value::BOOLEAN(WhisperConfig::DEFAULT_VOICE_QUERY_SHOW_SQL));
 
 	config.AddExtensionOption("whisper_voice_query_timeout", "Timeout for entire voice query operation (seconds)",
 	                          LogicalType::INTEGER, Value::INTEGER(WhisperConfig::DEFAULT_VOICE_QUERY_TIMEOUT));
+
+	config.AddExtensionOption("whisper_voice_query_max_tables",
+	                          "Send only this many best-matching tables to the text-to-sql proxy (0 = all)",
+	                          LogicalType::INTEGER, Value::INTEGER(WhisperConfig::DEFAULT_VOICE_QUERY_MAX_TABLES));
 #endif
 }
 
@@ -117,6 +236,73 @@ WhisperConfig WhisperConfigManager::GetConfig(ClientContext &context) {
 	if (context.TryGetCurrentSetting("whisper_threads", val)) {
 		config.threads = val.GetValue<int32_t>();
 	}
+	if (context.TryGetCurrentSetting("whisper_threads_policy", val)) {
+		config.threads_policy = val.GetValue<string>();
+	}
+	config.scheduler_threads = static_cast<int>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+	if (context.TryGetCurrentSetting("whisper_max_concurrent_states", val)) {
+		config.max_concurrent_states = val.GetValue<int32_t>();
+	}
+	if (context.TryGetCurrentSetting("whisper_model_cache_mb", val)) {
+		config.model_cache_mb = val.GetValue<int32_t>();
+	}
+	if (context.TryGetCurrentSetting("whisper_streaming", val)) {
+		config.streaming = val.GetValue<bool>();
+	}
+	if (context.TryGetCurrentSetting("whisper_stream_window", val)) {
+		config.stream_window = val.GetValue<double>();
+	}
+	if (context.TryGetCurrentSetting("whisper_parallel_chunks", val)) {
+		config.parallel_chunks = val.GetValue<int32_t>();
+	}
+	if (context.TryGetCurrentSetting("whisper_pack_clips", val)) {
+		config.pack_clips = val.GetValue<bool>();
+	}
+	if (context.TryGetCurrentSetting("whisper_cache", val)) {
+		config.cache = val.GetValue<bool>();
+	}
+	if (context.TryGetCurrentSetting("whisper_cache_size", val)) {
+		config.cache_size = val.GetValue<int32_t>();
+	}
+	if (context.TryGetCurrentSetting("whisper_cache_persist", val)) {
+		config.cache_persist = val.GetValue<bool>();
+	}
+	if (context.TryGetCurrentSetting("whisper_cache_disk_mb", val)) {
+		config.cache_disk_mb = val.GetValue<int32_t>();
+	}
+	if (context.TryGetCurrentSetting("whisper_input_format", val)) {
+		config.input_format = val.GetValue<string>();
+	}
+	if (context.TryGetCurrentSetting("whisper_vad", val)) {
+		config.vad = val.GetValue<bool>();
+	}
+	if (context.TryGetCurrentSetting("whisper_vad_threshold", val)) {
+		config.vad_threshold = val.GetValue<double>();
+	}
+	if (context.TryGetCurrentSetting("whisper_beam_size", val)) {
+		config.beam_size = val.GetValue<int32_t>();
+	}
+	if (context.TryGetCurrentSetting("whisper_best_of", val)) {
+		config.best_of = val.GetValue<int32_t>();
+	}
+	if (context.TryGetCurrentSetting("whisper_temperature", val)) {
+		config.temperature = val.GetValue<double>();
+	}
+	if (context.TryGetCurrentSetting("whisper_temperature_inc", val)) {
+		config.temperature_inc = val.GetValue<double>();
+	}
+	if (context.TryGetCurrentSetting("whisper_entropy_thold", val)) {
+		config.entropy_thold = val.GetValue<double>();
+	}
+	if (context.TryGetCurrentSetting("whisper_no_context", val)) {
+		config.no_context = val.GetValue<bool>();
+	}
+	if (context.TryGetCurrentSetting("whisper_audio_ctx", val)) {
+		config.audio_ctx = val.GetValue<int32_t>();
+	}
+	if (context.TryGetCurrentSetting("whisper_flash_attn", val)) {
+		config.flash_attn = val.GetValue<bool>();
+	}
 	if (context.TryGetCurrentSetting("whisper_device_id", val)) {
 		config.device_id = val.GetValue<int32_t>();
 	}
@@ -138,6 +324,9 @@ WhisperConfig WhisperConfigManager::GetConfig(ClientContext &context) {
 	if (context.TryGetCurrentSetting("whisper_use_gpu", val)) {
 		config.use_gpu = val.GetValue<bool>();
 	}
+	if (context.TryGetCurrentSetting("whisper_gpu_device", val)) {
+		config.gpu_device = val.GetValue<int32_t>();
+	}
 
 #ifdef WHISPER_ENABLE_VOICE_QUERY
 	if (context.TryGetCurrentSetting("whisper_text_to_sql_url", val)) {
@@ -146,12 +335,18 @@ WhisperConfig WhisperConfigManager::GetConfig(ClientContext &context) {
 	if (context.TryGetCurrentSetting("whisper_text_to_sql_timeout", val)) {
 		config.text_to_sql_timeout = val.GetValue<int32_t>();
 	}
+	if (context.TryGetCurrentSetting("whisper_text_to_sql_compress", val)) {
+		config.text_to_sql_compress = val.GetValue<bool>();
+	}
 	if (context.TryGetCurrentSetting("whisper_voice_query_show_sql", val)) {
 		config.voice_query_show_sql = val.GetValue<bool>();
 	}
 	if (context.TryGetCurrentSetting("whisper_voice_query_timeout", val)) {
 		config.voice_query_timeout = val.GetValue<int32_t>();
 	}
+	if (context.TryGetCurrentSetting("whisper_voice_query_max_tables", val)) {
+		config.voice_query_max_tables = val.GetValue<int32_t>();
+	}
 #endif
 
 	return config;
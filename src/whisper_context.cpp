@@ -1,5 +1,9 @@
 #include "whisper_context.hpp"
 #include "whisper.h"
+#include "ggml-backend.h"
+
+#include <algorithm>
+#include <sys/stat.h>
 
 namespace duckdb {
 
@@ -20,27 +24,89 @@ static void SuppressWhisperLogs() {
 	}
 }
 
-WhisperContextWrapper::WhisperContextWrapper(whisper_context *ctx) : ctx_(ctx) {
+WhisperContextWrapper::WhisperContextWrapper(whisper_context *ctx, bool owns_context)
+    : ctx_(ctx), owns_context_(owns_context), total_states_(0) {
 }
 
 WhisperContextWrapper::~WhisperContextWrapper() {
-	// Intentionally don't call whisper_free() to avoid Metal cleanup assertion
+	// Metal contexts are intentionally never freed to avoid the Metal cleanup assertion
 	// at program exit. The OS will reclaim resources anyway.
 	// This is a workaround for: https://github.com/ggml-org/llama.cpp/issues/17869
+	// Other contexts are freed, which is what makes unloading models reclaim memory.
+	// Destruction only happens once no lease references the wrapper, so all states are idle.
+	if (owns_context_) {
+		for (auto state : idle_states_) {
+			whisper_free_state(state);
+		}
+		if (ctx_) {
+			whisper_free(ctx_);
+		}
+	}
+	idle_states_.clear();
 	ctx_ = nullptr;
 }
 
-WhisperContextWrapper::WhisperContextWrapper(WhisperContextWrapper &&other) noexcept : ctx_(other.ctx_) {
-	other.ctx_ = nullptr;
+whisper_state *WhisperContextWrapper::AcquireState(idx_t max_states, std::string &error) {
+	if (max_states == 0) {
+		max_states = 1;
+	}
+
+	std::unique_lock<std::mutex> lock(state_mutex_);
+
+	// Wait until a state is idle or the pool may grow
+	state_cv_.wait(lock, [&]() { return !idle_states_.empty() || total_states_ < max_states; });
+
+	if (!idle_states_.empty()) {
+		whisper_state *state = idle_states_.back();
+		idle_states_.pop_back();
+		return state;
+	}
+
+	// Grow the pool (reserve the slot first so other threads see it)
+	total_states_++;
+	lock.unlock();
+
+	whisper_state *state = whisper_init_state(ctx_);
+	if (!state) {
+		lock.lock();
+		total_states_--;
+		lock.unlock();
+		state_cv_.notify_one();
+		error = "Failed to allocate whisper decoder state";
+		return nullptr;
+	}
+	return state;
 }
 
-WhisperContextWrapper &WhisperContextWrapper::operator=(WhisperContextWrapper &&other) noexcept {
-	if (this != &other) {
-		// Don't free old context (see destructor comment)
-		ctx_ = other.ctx_;
-		other.ctx_ = nullptr;
+void WhisperContextWrapper::ReleaseState(whisper_state *state) {
+	if (!state) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(state_mutex_);
+		idle_states_.push_back(state);
 	}
-	return *this;
+	state_cv_.notify_one();
+}
+
+idx_t WhisperContextWrapper::StateCount() {
+	std::lock_guard<std::mutex> lock(state_mutex_);
+	return total_states_;
+}
+
+WhisperStateLease::WhisperStateLease(std::shared_ptr<WhisperContextWrapper> ctx, idx_t max_states,
+                                     std::string &error)
+    : ctx_(std::move(ctx)), state_(nullptr) {
+	if (ctx_ && ctx_->IsValid()) {
+		state_ = ctx_->AcquireState(max_states, error);
+	}
+}
+
+WhisperStateLease::~WhisperStateLease() {
+	if (ctx_ && state_) {
+		ctx_->ReleaseState(state_);
+	}
+	state_ = nullptr;
 }
 
 WhisperContextManager &WhisperContextManager::GetInstance() {
@@ -50,41 +116,224 @@ WhisperContextManager &WhisperContextManager::GetInstance() {
 	return *instance;
 }
 
+// Bytes held by a loaded model; weights dominate and match the ggml file size closely
+static int64_t EstimateModelBytes(const std::string &model_path) {
+	struct stat buffer;
+	if (stat(model_path.c_str(), &buffer) != 0) {
+		return 0;
+	}
+	return static_cast<int64_t>(buffer.st_size);
+}
+
+// Contexts differ by every load option, so each option is part of the key
+static std::string ContextKey(const std::string &model_path, bool use_gpu, int gpu_device, bool flash_attn) {
+	return model_path + (use_gpu ? ":gpu" + std::to_string(gpu_device) : ":cpu") + (flash_attn ? ":fa" : "");
+}
+
+int WhisperContextManager::GpuDeviceCount() {
+	// Counted the way whisper.cpp numbers devices for whisper_context_params.gpu_device
+	static const int count = []() {
+		int n_devices = 0;
+		for (size_t i = 0; i < ggml_backend_dev_count(); i++) {
+			auto type = ggml_backend_dev_type(ggml_backend_dev_get(i));
+			if (type == GGML_BACKEND_DEVICE_TYPE_GPU || type == GGML_BACKEND_DEVICE_TYPE_IGPU) {
+				n_devices++;
+			}
+		}
+		return n_devices;
+	}();
+	return count;
+}
+
+idx_t WhisperContextManager::ScheduledDeviceCount(bool use_gpu, int gpu_device) {
+	if (!use_gpu || gpu_device >= 0) {
+		return 1;
+	}
+	return static_cast<idx_t>(MaxValue(GpuDeviceCount(), 1));
+}
+
+int WhisperContextManager::PickDevice(const std::string &model_path, bool flash_attn) {
+	// Every running transcription holds a reference to its context; ties go to the lowest device
+	int best_device = 0;
+	long best_load = 0;
+	for (int device = 0; device < GpuDeviceCount(); device++) {
+		auto it = contexts_.find(ContextKey(model_path, true, device, flash_attn));
+		long load = it == contexts_.end() ? 0 : it->second.context.use_count() - 1;
+		if (device == 0 || load < best_load) {
+			best_device = device;
+			best_load = load;
+		}
+	}
+	return best_device;
+}
+
 std::shared_ptr<WhisperContextWrapper> WhisperContextManager::GetContext(const std::string &model_path, bool use_gpu,
-                                                                         std::string &error) {
-	std::lock_guard<std::mutex> lock(mutex_);
+                                                                         int gpu_device, bool flash_attn,
+                                                                         idx_t budget_mb, std::string &error,
+                                                                         bool *loaded) {
+	std::unique_lock<std::mutex> lock(mutex_);
+	if (loaded) {
+		*loaded = false;
+	}
 
 	// Suppress verbose logging from whisper.cpp
 	SuppressWhisperLogs();
 
-	// Create cache key that includes GPU setting
-	std::string cache_key = model_path + (use_gpu ? ":gpu" : ":cpu");
+	int n_devices = GpuDeviceCount();
+	if (!use_gpu) {
+		gpu_device = -1;
+	} else if (gpu_device < 0) {
+		gpu_device = PickDevice(model_path, flash_attn);
+	} else if (n_devices > 0 && gpu_device >= n_devices) {
+		error = "whisper_gpu_device " + std::to_string(gpu_device) + " does not exist (" +
+		        std::to_string(n_devices) + " GPU" + (n_devices == 1 ? "" : "s") + " available)";
+		return nullptr;
+	}
 
-	// Check if already cached
-	auto it = contexts_.find(cache_key);
-	if (it != contexts_.end() && it->second && it->second->IsValid()) {
-		return it->second;
+	// Create cache key that includes the load options
+	std::string cache_key = ContextKey(model_path, use_gpu, gpu_device, flash_attn);
+
+	// Check if already cached; a load of the same model by another thread is waited for instead of repeated
+	while (true) {
+		auto it = contexts_.find(cache_key);
+		if (it != contexts_.end() && it->second.context && it->second.context->IsValid()) {
+			it->second.last_used = ++use_counter_;
+			return it->second.context;
+		}
+		if (loading_.find(cache_key) == loading_.end()) {
+			break;
+		}
+		loading_cv_.wait(lock);
+	}
+
+	// Make room before loading so two large models are not resident at once (models still loading count too)
+	int64_t memory_bytes = EstimateModelBytes(model_path);
+	if (budget_mb > 0) {
+		int64_t loading_bytes = 0;
+		for (auto &entry : loading_) {
+			loading_bytes += entry.second;
+		}
+		EvictForBudget(memory_bytes + loading_bytes, static_cast<int64_t>(budget_mb) * 1024 * 1024);
 	}
+	loading_[cache_key] = memory_bytes;
 
-	// Load new context
+	// Load model weights only; decoder states are created on demand by the pool
 	whisper_context_params cparams = whisper_context_default_params();
 	cparams.use_gpu = use_gpu;
+	cparams.gpu_device = MaxValue(gpu_device, 0);
+	cparams.flash_attn = flash_attn;
 
-	whisper_context *ctx = whisper_init_from_file_with_params(model_path.c_str(), cparams);
+	// Loading takes seconds for large models; other models are served meanwhile
+	lock.unlock();
+	whisper_context *ctx = whisper_init_from_file_with_params_no_state(model_path.c_str(), cparams);
+	lock.lock();
+	loading_.erase(cache_key);
+	loading_cv_.notify_all();
 	if (!ctx) {
 		error = "Failed to load whisper model from: " + model_path;
 		return nullptr;
 	}
 
-	auto wrapper = std::make_shared<WhisperContextWrapper>(ctx);
-	contexts_[cache_key] = wrapper;
+#ifdef __APPLE__
+	bool owns_context = !use_gpu;
+#else
+	bool owns_context = true;
+#endif
+
+	CachedContext entry;
+	entry.context = std::make_shared<WhisperContextWrapper>(ctx, owns_context);
+	entry.model_path = model_path;
+	entry.use_gpu = use_gpu;
+	entry.gpu_device = gpu_device;
+	entry.flash_attn = flash_attn;
+	entry.memory_bytes = memory_bytes;
+	entry.last_used = ++use_counter_;
+	contexts_[cache_key] = entry;
 
-	return wrapper;
+	if (loaded) {
+		*loaded = true;
+	}
+	return entry.context;
+}
+
+void WhisperContextManager::EvictForBudget(int64_t incoming_bytes, int64_t budget_bytes) {
+	int64_t resident_bytes = 0;
+	for (auto &entry : contexts_) {
+		resident_bytes += entry.second.memory_bytes;
+	}
+
+	while (resident_bytes + incoming_bytes > budget_bytes) {
+		// Models referenced by a running transcription would stay resident anyway, so skip them
+		auto victim = contexts_.end();
+		for (auto it = contexts_.begin(); it != contexts_.end(); ++it) {
+			if (it->second.context.use_count() > 1) {
+				continue;
+			}
+			if (victim == contexts_.end() || it->second.last_used < victim->second.last_used) {
+				victim = it;
+			}
+		}
+		if (victim == contexts_.end()) {
+			break;
+		}
+		resident_bytes -= victim->second.memory_bytes;
+		contexts_.erase(victim);
+	}
+}
+
+bool WhisperContextManager::IsLoaded(const std::string &model_path, bool use_gpu, int gpu_device, bool flash_attn) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (use_gpu && gpu_device < 0) {
+		for (auto &entry : contexts_) {
+			if (entry.second.model_path == model_path && entry.second.use_gpu &&
+			    entry.second.flash_attn == flash_attn) {
+				return true;
+			}
+		}
+		return false;
+	}
+	return contexts_.find(ContextKey(model_path, use_gpu, use_gpu ? gpu_device : -1, flash_attn)) != contexts_.end();
+}
+
+std::vector<LoadedModelInfo> WhisperContextManager::ListContexts() {
+	std::vector<std::pair<uint64_t, LoadedModelInfo>> entries;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (auto &entry : contexts_) {
+			LoadedModelInfo info;
+			info.model_path = entry.second.model_path;
+			info.use_gpu = entry.second.use_gpu;
+			info.gpu_device = entry.second.gpu_device;
+			info.flash_attn = entry.second.flash_attn;
+			info.memory_bytes = entry.second.memory_bytes;
+			info.decoder_states = entry.second.context->StateCount();
+			info.in_use = entry.second.context.use_count() > 1;
+			entries.emplace_back(entry.second.last_used, info);
+		}
+	}
+
+	std::sort(entries.begin(), entries.end(),
+	          [](const std::pair<uint64_t, LoadedModelInfo> &a, const std::pair<uint64_t, LoadedModelInfo> &b) {
+		          return a.first > b.first;
+	          });
+
+	std::vector<LoadedModelInfo> result;
+	result.reserve(entries.size());
+	for (auto &entry : entries) {
+		result.push_back(entry.second);
+	}
+	return result;
 }
 
 void WhisperContextManager::ClearContext(const std::string &model_path) {
 	std::lock_guard<std::mutex> lock(mutex_);
-	contexts_.erase(model_path);
+	for (auto it = contexts_.begin(); it != contexts_.end();) {
+		if (it->second.model_path == model_path) {
+			it = contexts_.erase(it);
+		} else {
+			++it;
+		}
+	}
 }
 
 void WhisperContextManager::ClearAllContexts() {
@@ -17,6 +17,7 @@ namespace duckdb {
 void RegisterModelFunctions(ExtensionLoader &loader);
 void RegisterTranscribeScalarFunctions(ExtensionLoader &loader);
 void RegisterTranscribeTableFunctions(ExtensionLoader &loader);
+void RegisterTranscribeJobFunction(ExtensionLoader &loader);
 void RegisterUtilityFunctions(ExtensionLoader &loader);
 
 #ifdef WHISPER_ENABLE_RECORDING
@@ -41,6 +42,7 @@ static void LoadInternal(ExtensionLoader &loader) {
 	RegisterModelFunctions(loader);
 	RegisterTranscribeScalarFunctions(loader);
 	RegisterTranscribeTableFunctions(loader);
+	RegisterTranscribeJobFunction(loader);
 	RegisterUtilityFunctions(loader);
 
 #ifdef WHISPER_ENABLE_RECORDING